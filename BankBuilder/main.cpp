@@ -0,0 +1,213 @@
+#include "PropagationKernel.h"
+#include "PuzzleBank.h"
+#include "SudokuCanonicalizer.h"
+#include "SudokuSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+static constexpr const size_t BATCH_SIZE = 4096;
+
+static bool isConsistent(const Propagation& propagation, const Puzzle& puzzle)
+{
+	if (propagation.contradiction)
+	{
+		return false;
+	}
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		const int digit = puzzle.solution.Get(cell);
+		if (propagation.cells[cell] ? propagation.cells[cell] != digit : !(propagation.candidates[cell] & SudokuBoard::ToMask(digit)))
+		{
+			return false;
+		}
+	}
+	// singles alone solve exactly the easy puzzles
+	return (puzzle.difficulty == Difficulty::easy) == (propagation.filled == SudokuBoard::NUMBER_OF_CELLS);
+}
+
+static void generate(Difficulty difficulty, size_t count, uint32_t seed, SolverKind solverKind, std::vector<PuzzleRecord>& records)
+{
+	SudokuGenerator generator(seed, solverKind);
+	SudokuCanonicalizer canonicalizer;
+	const PropagationKernel kernel;
+	std::vector<Puzzle> puzzles;
+	std::vector<SudokuBoard> boards;
+	std::vector<Propagation> results;
+	records.reserve(count);
+	while (records.size() < count)
+	{
+		puzzles.clear();
+		boards.clear();
+		while (puzzles.size() < std::min(BATCH_SIZE, count - records.size()))
+		{
+			Puzzle puzzle = generator.Generate(difficulty);
+			if (puzzle.difficulty == difficulty)
+			{
+				boards.push_back(puzzle.clues);
+				puzzles.push_back(std::move(puzzle));
+			}
+		}
+		// a whole batch is propagated at once, a puzzle whose singles disagree with its grade or
+		// its solution never makes it into the bank
+		results.resize(puzzles.size());
+		kernel.Propagate(boards.data(), boards.size(), results.data());
+		for (size_t i = 0; i < puzzles.size(); ++i)
+		{
+			if (!isConsistent(results[i], puzzles[i]))
+			{
+				continue;
+			}
+			// the bank stores canonical forms, so equivalent puzzles become identical records
+			Puzzle& puzzle = puzzles[i];
+			SudokuTransform transform;
+			puzzle.clues = canonicalizer.Canonicalize(puzzle.clues, &transform);
+			puzzle.solution = transform.Apply(puzzle.solution);
+			records.push_back(PuzzleBank::ToRecord(puzzle));
+		}
+	}
+}
+
+static bool matchesReference(const Propagation& result, const Propagation& reference)
+{
+	// after a contradiction the boards are left half propagated, only the verdict has to agree
+	return reference.contradiction ? result.contradiction : result == reference;
+}
+
+// propagates every record with the fastest kernel, checks it bit for bit against the singles of
+// the scalar solver and checks that singles never contradict the stored solution or the grade
+static int validate(const std::string& path)
+{
+	PuzzleBank bank;
+	if (!bank.Open(path))
+	{
+		std::cerr << "could not open " << path << '\n';
+		return 1;
+	}
+	const PropagationKernel kernel;
+	SudokuSolver solver;
+	std::vector<Puzzle> puzzles(BATCH_SIZE);
+	std::vector<SudokuBoard> boards(BATCH_SIZE);
+	std::vector<Propagation> results(BATCH_SIZE);
+	std::vector<Propagation> expected(BATCH_SIZE);
+	std::chrono::duration<double> kernelTime(0);
+	std::chrono::duration<double> solverTime(0);
+	size_t failures = 0;
+	for (size_t i = 0; i < size_t(Difficulty::count); ++i)
+	{
+		const Difficulty difficulty = Difficulty(i);
+		size_t solvedBySingles = 0;
+		for (size_t first = 0; first < bank.GetCount(difficulty); first += BATCH_SIZE)
+		{
+			const size_t count = std::min(BATCH_SIZE, bank.GetCount(difficulty) - first);
+			for (size_t j = 0; j < count; ++j)
+			{
+				bank.Get(difficulty, first + j, puzzles[j]);
+				boards[j] = puzzles[j].clues;
+			}
+			auto start = std::chrono::steady_clock::now();
+			kernel.Propagate(boards.data(), count, results.data());
+			kernelTime += std::chrono::steady_clock::now() - start;
+			start = std::chrono::steady_clock::now();
+			for (size_t j = 0; j < count; ++j)
+			{
+				solver.PropagateSingles(boards[j], expected[j]);
+			}
+			solverTime += std::chrono::steady_clock::now() - start;
+			for (size_t j = 0; j < count; ++j)
+			{
+				if (!matchesReference(results[j], expected[j]) || !isConsistent(results[j], puzzles[j]))
+				{
+					std::cerr << toString(difficulty) << " #" << first + j << " " << puzzles[j].clues.ToString() << " failed validation\n";
+					++failures;
+				}
+				solvedBySingles += results[j].filled == SudokuBoard::NUMBER_OF_CELLS ? 1 : 0;
+			}
+		}
+		std::cout << toString(difficulty) << ": " << bank.GetCount(difficulty) << " puzzles, " << solvedBySingles << " solved by singles\n";
+	}
+	std::cout << toString(kernel.GetLevel()) << " kernel " << kernelTime.count() << "s, scalar solver " << solverTime.count() << "s, "
+		<< failures << " failures\n";
+	return failures ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cerr << "usage: BankBuilder <output> [puzzles per difficulty] [threads] [bitboard|dancingLinks]\n"
+			"       BankBuilder --validate <bank>\n";
+		return 1;
+	}
+	if (std::string(argv[1]) == "--validate")
+	{
+		return argc > 2 ? validate(argv[2]) : 1;
+	}
+	const std::string outputPath = argv[1];
+	const size_t count = argc > 2 ? std::stoul(argv[2]) : 1000;
+	const size_t numberOfThreads = std::max<size_t>(1, argc > 3 ? std::stoul(argv[3]) : std::thread::hardware_concurrency());
+	SolverKind solverKind = SolverKind::bitboard;
+	if (argc > 4 && !toSolverKind(argv[4], solverKind))
+	{
+		std::cerr << "unknown solver " << argv[4] << '\n';
+		return 1;
+	}
+
+	PuzzleBankHeader header = {};
+	std::copy(std::begin(PuzzleBank::MAGIC), std::end(PuzzleBank::MAGIC), header.magic);
+	header.version = PuzzleBank::VERSION;
+	header.recordSize = sizeof(PuzzleRecord);
+
+	std::ofstream out(outputPath, std::ios::binary);
+	if (!out)
+	{
+		std::cerr << "could not open " << outputPath << '\n';
+		return 1;
+	}
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	std::unordered_set<std::string> seen;
+	for (size_t i = 0; i < size_t(Difficulty::count); ++i)
+	{
+		const Difficulty difficulty = Difficulty(i);
+		size_t duplicates = 0;
+		// duplicates are dropped and topped up by further rounds with fresh seeds
+		for (size_t round = 0; header.counts[i] < count; ++round)
+		{
+			const size_t missing = count - header.counts[i];
+			std::vector<std::vector<PuzzleRecord>> shards(numberOfThreads);
+			std::vector<std::thread> workers;
+			for (size_t t = 0; t < numberOfThreads; ++t)
+			{
+				const size_t share = missing / numberOfThreads + (t < missing % numberOfThreads ? 1 : 0);
+				const uint32_t seed = uint32_t((round * size_t(Difficulty::count) + i) * numberOfThreads + t + 1);
+				workers.emplace_back(generate, difficulty, share, seed, solverKind, std::ref(shards[t]));
+			}
+			for (std::thread& worker : workers)
+			{
+				worker.join();
+			}
+			for (const std::vector<PuzzleRecord>& shard : shards)
+			{
+				for (const PuzzleRecord& record : shard)
+				{
+					if (!seen.insert(std::string(std::begin(record.clues), std::end(record.clues))).second)
+					{
+						++duplicates;
+						continue;
+					}
+					out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+					++header.counts[i];
+				}
+			}
+		}
+		std::cout << toString(difficulty) << ": " << header.counts[i] << " puzzles, " << duplicates << " duplicates dropped\n";
+	}
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	return out ? 0 : 1;
+}
@@ -1,25 +1,43 @@
 #include "Client.h"
 #include "Window.h"
+#include <array>
 #include <chrono>
 #include <sstream>
 #include <ws2tcpip.h>
 
 bool isIpAddress(const std::string& ip);
 
-Client::Client(unsigned long timeout)
-	: timeout(timeout)
-{
-	handlers["serverConfig"] = &Window::HandleServerConfig;
-	handlers["usersList"] = &Window::HandleUserList;
-	handlers["addUser"] = &Window::HandleAddUser;
-	handlers["changeUser"] = &Window::HandeChangeUser;
-	handlers["removeUser"] = &Window::HandleRemoveUser;
-	handlers["roomsList"] = &Window::HandleRoomList;
-	handlers["addRoom"] = &Window::HandleAddRoom;
-	handlers["removeRoom"] = &Window::HandleRemoveRoom;
-	handlers["changeRoom"] = &Window::HandleRoomChange;
-	handlers["join"] = &Window::HandleJoin;
-	handlers["quit"] = &Window::HandleQuit;
+namespace
+{
+	using MessageHandler = void (Window::*)(const Json& message);
+
+	// messages are dispatched by the type decodeMessage interned, types without a handler stay empty
+	const std::array<MessageHandler, size_t(MessageType::count)> HANDLERS = [] {
+		std::array<MessageHandler, size_t(MessageType::count)> handlers = {};
+		handlers[size_t(MessageType::serverConfig)] = &Window::HandleServerConfig;
+		handlers[size_t(MessageType::usersList)] = &Window::HandleUserList;
+		handlers[size_t(MessageType::addUser)] = &Window::HandleAddUser;
+		handlers[size_t(MessageType::changeUser)] = &Window::HandeChangeUser;
+		handlers[size_t(MessageType::removeUser)] = &Window::HandleRemoveUser;
+		handlers[size_t(MessageType::roomsList)] = &Window::HandleRoomList;
+		handlers[size_t(MessageType::roomsPage)] = &Window::HandleRoomsPage;
+		handlers[size_t(MessageType::addRoom)] = &Window::HandleAddRoom;
+		handlers[size_t(MessageType::removeRoom)] = &Window::HandleRemoveRoom;
+		handlers[size_t(MessageType::changeRoom)] = &Window::HandleRoomChange;
+		handlers[size_t(MessageType::join)] = &Window::HandleJoin;
+		handlers[size_t(MessageType::quit)] = &Window::HandleQuit;
+		handlers[size_t(MessageType::start)] = &Window::HandleStart;
+		handlers[size_t(MessageType::ready)] = &Window::HandleReady;
+		handlers[size_t(MessageType::move)] = &Window::HandleMove;
+		handlers[size_t(MessageType::hint)] = &Window::HandleHint;
+		handlers[size_t(MessageType::finish)] = &Window::HandleFinish;
+		return handlers;
+	}();
+}
+
+Client::Client(unsigned long timeout, Encoding preferredEncoding)
+	: timeout(timeout), preferredEncoding(preferredEncoding)
+{
 }
 
 
@@ -136,6 +154,15 @@ void Client::establishConnection(const std::string& name, const IPEndpoint& serv
 	Json message;
 	message["type"] = "connect";
 	message["name"] = name;
+	message["encoding"] = toString(preferredEncoding);
+	message["limit"] = ROOMS_PAGE_SIZE;
+	if (lobbyEpoch != 0)
+	{
+		// the server replays what changed since the last lobby version this client saw
+		message["epoch"] = lobbyEpoch;
+		message["version"] = lobbyVersion;
+	}
+	encoding = Encoding::json;
 	Result result = socket.sendJson(message);
 	if (result != Result::success)
 	{
@@ -175,6 +202,8 @@ void Client::establishConnection(const std::string& name, const IPEndpoint& serv
 		clientThread.reset();
 		return;
 	}
+	encoding = toEncoding(message.value("encoding", "json"));
+	lobbyEpoch = message.value("epoch", 0ll);
 	connected.store(true);
 	wnd->HandleConnection();
 	waitForMessages();
@@ -188,7 +217,8 @@ void Client::recieveDataT(Json& recievedData, Result& result)
 
 Result Client::sendMessage(Json& message)
 {
-	Result result = socket.sendJson(message);
+	std::string payload = encodeMessage(message, encoding);
+	Result result = socket.sendFrame(payload.c_str(), (int)payload.size());
 	if (result != Result::success)
 	{
 		return Result::genericError;
@@ -198,13 +228,15 @@ Result Client::sendMessage(Json& message)
 
 void Client::waitForMessages()
 {
+	std::string payload;
 	Json message;
+	MessageType type = MessageType::unknown;
 	Result result = Result::success;
-	while (connected.load() && (result = socket.recieveJson(message)) != Result::connectionReset)
+	while (connected.load() && (result = socket.recieveFrame(payload)) != Result::connectionReset)
 	{
-		if (result == Result::success)
+		if (result == Result::success && decodeMessage(payload.c_str(), payload.size(), encoding, message, type) == Result::success)
 		{
-			handleMessage(message);
+			handleMessage(type, message);
 		}
 	}
 	if (result == Result::connectionReset)
@@ -213,15 +245,18 @@ void Client::waitForMessages()
 	}
 }
 
-void Client::handleMessage(const Json& message)
+void Client::handleMessage(MessageType type, const Json& message)
 {
-	auto it = message.find("type");
-	if (it == message.end())
+	auto version = message.find("version");
+	if (version != message.end() && version->is_number_integer())
 	{
-		return;
+		lobbyVersion = version->get<long long>();
+	}
+	const MessageHandler handler = HANDLERS[size_t(type)];
+	if (handler)
+	{
+		(wnd->*handler)(message);
 	}
-	std::string type = *it;
-	handlers[*it](wnd, message);
 }
 
 bool isIpAddress(const std::string& ip)
@@ -1,6 +1,7 @@
 #pragma once
 #include "ClientSocket.h"
 #include "TransmissionType.h"
+#include "Protocol.h"
 #include <memory>
 #include <thread>
 #include <atomic>
@@ -9,13 +10,16 @@
 class Client
 {
 public:
-	Client(unsigned long timeout);
+	// the lobby only holds one page of rooms, the server follows the changes of those alone
+	static constexpr const int ROOMS_PAGE_SIZE = 50;
+public:
+	Client(unsigned long timeout, Encoding preferredEncoding = DEFAULT_ENCODING);
 	void connect(const std::string& name, const std::string& ip, const std::string& portStr);
 	void bind(IPEndpoint endpoint);
 	void join();
 	Result sendMessage(Json& message);
 	void waitForMessages();
-	void handleMessage(const Json& message);
+	void handleMessage(MessageType type, const Json& message);
 	TransmissionType getTransmissionType() const;
 	void setWindow(class Window* wnd);
 	bool isConnected() const;
@@ -25,13 +29,21 @@ private:
 	void establishConnection(const std::string& name, const IPEndpoint& serverEndpoint);
 	void recieveDataT(Json& recievedData, Result& result);
 private:
+#ifdef NDEBUG
+	static constexpr const Encoding DEFAULT_ENCODING = Encoding::binary;
+#else
+	static constexpr const Encoding DEFAULT_ENCODING = Encoding::json;
+#endif
 	unsigned long timeout;
+	Encoding preferredEncoding;
+	Encoding encoding = Encoding::json;
+	long long lobbyEpoch = 0;
+	long long lobbyVersion = 0;
 	ClientSocket socket;
 	std::unique_ptr<std::thread> clientThread;
 	std::atomic<bool> connected = true;
 	static constexpr const TransmissionType transmissionType = TransmissionType::unicast;
 	class Window* wnd;
-	std::map<std::string, std::function<void(class Window* wnd, const Json& message)>> handlers;
 };
 
 
@@ -25,8 +25,12 @@ Result ClientSocket::connect(IPEndpoint endpoint)
     }
     if (result != 0)
     {
-        int errorCode = WSAGetLastError();
+        int errorCode = lastSocketError();
+#ifdef __linux__
+        if (errorCode == EISCONN)
+#else
         if (errorCode == WSAEISCONN)
+#endif
         {
             return Result::success;
         }
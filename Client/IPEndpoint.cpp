@@ -1,6 +1,6 @@
 #include "IPEndpoint.h"
-#include <WS2tcpip.h>
 #include <assert.h>
+#include <cstring>
 
 IPEndpoint::IPEndpoint(const char* ip, unsigned short port)
     : port(port)
@@ -11,12 +11,12 @@ IPEndpoint::IPEndpoint(const char* ip, unsigned short port)
 
     if (result == 1)
     {
-        if (addr.S_un.S_addr != INADDR_NONE)
+        if (addr.s_addr != INADDR_NONE)
         {
             ipString = ip;
             hostname = ip;
-            ipBytes.resize(sizeof(ULONG));
-            memcpy(ipBytes.data(), &addr.S_un.S_addr, sizeof(ULONG));
+            ipBytes.resize(sizeof(uint32_t));
+            memcpy(ipBytes.data(), &addr.s_addr, sizeof(uint32_t));
             ipversion = IPVersion::IPv4;
             return;
         }
@@ -33,9 +33,9 @@ IPEndpoint::IPEndpoint(const char* ip, unsigned short port)
         inet_ntop(AF_INET, &hostAddr->sin_addr, &ipString[0], 16);
 
         hostname = ip;
-        ULONG ipLong = hostAddr->sin_addr.S_un.S_addr;
-        ipBytes.resize(sizeof(LONG));
-        memcpy(ipBytes.data(), &ipLong, sizeof(ULONG));
+        uint32_t ipLong = hostAddr->sin_addr.s_addr;
+        ipBytes.resize(sizeof(uint32_t));
+        memcpy(ipBytes.data(), &ipLong, sizeof(uint32_t));
         ipversion = IPVersion::IPv4;
 
         freeaddrinfo(hostinfo);
@@ -51,13 +51,13 @@ IPEndpoint::IPEndpoint(const char* ip, unsigned short port)
          ipString = ip;
          hostname = ip;
          ipBytes.resize(16);
-         memcpy(ipBytes.data(), &addr6.u, 16);
+         memcpy(ipBytes.data(), &addr6.s6_addr, 16);
          ipversion = IPVersion::IPv6;
          return;
     }
 
     addrinfo hintsv6 = {};
-    hints.ai_family = AF_INET6;
+    hintsv6.ai_family = AF_INET6;
     addrinfo* hostinfov6 = nullptr;
     result = getaddrinfo(ip, NULL, &hintsv6, &hostinfov6);
     if (result == 0)
@@ -71,7 +71,7 @@ IPEndpoint::IPEndpoint(const char* ip, unsigned short port)
         memcpy(ipBytes.data(),  &hostAddr->sin6_addr, 16);
         ipversion = IPVersion::IPv6;
 
-        freeaddrinfo(hostinfo);
+        freeaddrinfo(hostinfov6);
         return;
     }
 }
@@ -84,8 +84,8 @@ IPEndpoint::IPEndpoint(const sockaddr* addr)
         const sockaddr_in* addrv4 = reinterpret_cast<const sockaddr_in*>(addr);
         ipversion = IPVersion::IPv4;
         port = ntohs(addrv4->sin_port);
-        ipBytes.resize(sizeof(ULONG));
-        memcpy(ipBytes.data(), &addrv4->sin_addr.S_un, sizeof(ULONG));
+        ipBytes.resize(sizeof(uint32_t));
+        memcpy(ipBytes.data(), &addrv4->sin_addr, sizeof(uint32_t));
         ipString.resize(16);
         inet_ntop(AF_INET, &addrv4->sin_addr, &ipString[0], 16);
         hostname = ipString;
@@ -133,7 +133,7 @@ sockaddr_in IPEndpoint::getSockaddrIPv4() const
     assert(ipversion == IPVersion::IPv4);
     sockaddr_in addr = {};
     addr.sin_family = AF_INET;
-    memcpy(&addr.sin_addr, ipBytes.data(), sizeof(ULONG));
+    memcpy(&addr.sin_addr, ipBytes.data(), sizeof(uint32_t));
     addr.sin_port = htons(port);
     return addr;
 }
@@ -0,0 +1,62 @@
+#pragma once
+#include "SudokuTables.h"
+#include <string>
+#include <vector>
+
+class LiveBoard
+{
+public:
+	struct Move
+	{
+		uint8_t cell;
+		uint8_t previous;
+		uint8_t digit;
+	};
+public:
+	static constexpr const int SIZE = SudokuTables::SIZE;
+	static constexpr const int NUMBER_OF_CELLS = SudokuTables::NUMBER_OF_CELLS;
+	static constexpr const DigitMask ALL_DIGITS = SudokuTables::ALL_DIGITS;
+public:
+	LiveBoard();
+	bool Load(const std::string& puzzle);
+	int Get(int cell) const
+	{
+		return cells[cell];
+	}
+	bool IsGiven(int cell) const
+	{
+		return givens[cell] != 0;
+	}
+	bool Place(int cell, int digit);
+	bool Erase(int cell);
+	bool Undo();
+	DigitMask GetCandidates(int cell) const;
+	bool HasConflict(int cell) const;
+	int GetRemaining() const
+	{
+		return remaining;
+	}
+	bool HasConflicts() const
+	{
+		return numberOfConflicts > 0;
+	}
+	bool IsSolved() const
+	{
+		return remaining == 0 && numberOfConflicts == 0;
+	}
+	std::string ToString() const;
+private:
+	void Set(int cell, int digit);
+	void Add(int unit, int digit);
+	void Remove(int unit, int digit);
+private:
+	static constexpr const int NUMBER_OF_UNITS = SudokuTables::NUMBER_OF_UNITS;
+	uint8_t cells[NUMBER_OF_CELLS];
+	uint8_t givens[NUMBER_OF_CELLS];
+	uint8_t counts[NUMBER_OF_UNITS][SIZE];
+	DigitMask occupied[NUMBER_OF_UNITS];
+	DigitMask conflicts[NUMBER_OF_UNITS];
+	int remaining = NUMBER_OF_CELLS;
+	int numberOfConflicts = 0;
+	std::vector<Move> history;
+};
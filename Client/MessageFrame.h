@@ -0,0 +1,11 @@
+#pragma once
+#include "Result.h"
+#include <cstdint>
+#include <string>
+
+constexpr const size_t FRAME_HEADER_SIZE = 4;
+constexpr const uint32_t MAX_FRAME_SIZE = 1u << 20;
+
+void writeFrameHeader(char* destination, uint32_t payloadSize);
+void appendFrameHeader(std::string& destination, uint32_t payloadSize);
+Result peekFrame(const char* data, size_t size, const char*& payload, uint32_t& payloadSize);
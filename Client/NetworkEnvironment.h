@@ -1,6 +1,5 @@
 #pragma once
-#define WIN32_LEAN_AND_MEAN
-#include <WinSock2.h>
+#include "SocketHandle.h"
 
 class NetworkEnvironment
 {
@@ -1,7 +1,12 @@
 #include "Socket.h"
 #include "NetworkException.h"
 #include <assert.h>
+#include <cstring>
 #include <sstream>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/time.h>
+#endif
 
 
 Socket::Socket(IPVersion ipversion, SocketHandle handle)
@@ -11,7 +16,7 @@ Socket::Socket(IPVersion ipversion, SocketHandle handle)
 }
 
 Socket::Socket(Socket&& source)
-    : ipversion(source.ipversion), handle(source.handle)
+    : ipversion(source.ipversion), handle(source.handle), recieveBuffer(std::move(source.recieveBuffer))
 {
     source.ipversion = IPVersion::Unknown;
     source.handle = INVALID_SOCKET;
@@ -29,6 +34,7 @@ Socket& Socket::operator=(Socket&& rhs)
     }
     ipversion = rhs.ipversion;
     handle = rhs.handle;
+    recieveBuffer = std::move(rhs.recieveBuffer);
     rhs.ipversion = IPVersion::Unknown;
     rhs.handle = INVALID_SOCKET;
     return *this;
@@ -47,13 +53,13 @@ void Socket::create(TransmissionType transmissionType, DWORD timeout)
         handle = socket(ipversion == IPVersion::IPv4 ? AF_INET : AF_INET6, SOCK_STREAM, IPPROTO_TCP);
         if (handle == INVALID_SOCKET)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             throw NETWORK_EXCEPTION(errorCode);
         }
 
         if (setSocketOption(SocketOption::TCP_NoDelay, TRUE) != Result::success)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             throw NETWORK_EXCEPTION(errorCode);
         }
     }
@@ -62,24 +68,24 @@ void Socket::create(TransmissionType transmissionType, DWORD timeout)
         handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
         if (handle == INVALID_SOCKET)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             throw NETWORK_EXCEPTION(errorCode);
         }
 
         if (setSocketOption(SocketOption::SO_Broadcast, TRUE) != Result::success)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             throw NETWORK_EXCEPTION(errorCode);
         }
     }
     if (setSocketOption(SocketOption::SO_RecieveTimeout, timeout) != Result::success)
     {
-        int errorCode = WSAGetLastError();
+        int errorCode = lastSocketError();
         throw NETWORK_EXCEPTION(errorCode);
     }
     if (setIOMode(IOMode::fionbio, 0ul) != Result::success)
     {
-        int errorCode = WSAGetLastError();
+        int errorCode = lastSocketError();
         throw NETWORK_EXCEPTION(errorCode);
     }
 }
@@ -93,7 +99,7 @@ Result Socket::bind(IPEndpoint endpoint)
         int result = ::bind(handle, reinterpret_cast<sockaddr*>(&addr), sizeof(sockaddr_in));
         if (result != 0)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             throw NETWORK_EXCEPTION(errorCode);
         }
     }
@@ -103,7 +109,7 @@ Result Socket::bind(IPEndpoint endpoint)
         int result = ::bind(handle, reinterpret_cast<sockaddr*>(&addr), sizeof(sockaddr_in6));
         if (result != 0)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             throw NETWORK_EXCEPTION(errorCode);
         }
     }
@@ -117,10 +123,10 @@ Result Socket::close()
         return Result::genericError;
     }
 
-    int result = closesocket(handle);
+    int result = closeSocket(handle);
     if (result != 0)
     {
-        int errorCode = WSAGetLastError();
+        int errorCode = lastSocketError();
         throw NETWORK_EXCEPTION(errorCode);
     }
 
@@ -130,10 +136,10 @@ Result Socket::close()
 
 Result Socket::send(const void* data, int numberOfBytes, int& bytesSent)
 {
-    bytesSent = ::send(handle, reinterpret_cast<const char*>(data), numberOfBytes, NULL);
+    bytesSent = ::send(handle, reinterpret_cast<const char*>(data), numberOfBytes, 0);
     if (bytesSent == SOCKET_ERROR)
     {
-        return errorCodeToResult(WSAGetLastError());
+        return errorCodeToResult(lastSocketError());
     }
     return Result::success;
 }
@@ -146,7 +152,7 @@ Result Socket::sendAll(const void* data, int numberOfBytes)
         int bytesRemaining = numberOfBytes - totalBytesSent;
         int bytesSent = 0;
         const char* bufferOffset = reinterpret_cast<const char*>(data) + totalBytesSent;
-        Result result = send(bufferOffset, numberOfBytes, bytesSent);
+        Result result = send(bufferOffset, bytesRemaining, bytesSent);
         if (result != Result::success)
         {
             return Result::genericError;
@@ -156,11 +162,65 @@ Result Socket::sendAll(const void* data, int numberOfBytes)
     return Result::success;
 }
 
+Result Socket::sendv(const SocketBuffer* buffers, int numberOfBuffers, int& bytesSent)
+{
+#ifdef __linux__
+    const ssize_t result = ::writev(handle, buffers, numberOfBuffers);
+    if (result < 0)
+    {
+        bytesSent = 0;
+        return errorCodeToResult(lastSocketError());
+    }
+    bytesSent = int(result);
+#else
+    DWORD sent = 0;
+    if (WSASend(handle, const_cast<WSABUF*>(buffers), DWORD(numberOfBuffers), &sent, 0, nullptr, nullptr) == SOCKET_ERROR)
+    {
+        bytesSent = 0;
+        return errorCodeToResult(lastSocketError());
+    }
+    bytesSent = int(sent);
+#endif
+    return Result::success;
+}
+
 Result Socket::sendJson(const Json& jsonData)
 {
     std::string jsonDataStr = jsonData.dump();
-    jsonDataStr.shrink_to_fit();
-    return sendAll(jsonDataStr.c_str(), (int)jsonDataStr.size());
+    return sendFrame(jsonDataStr.c_str(), (int)jsonDataStr.size());
+}
+
+Result Socket::sendFrame(const void* payload, int payloadSize)
+{
+    // header and payload go out in one vectored send instead of being copied into a frame
+    char header[FRAME_HEADER_SIZE];
+    const int headerSize = int(FRAME_HEADER_SIZE);
+    writeFrameHeader(header, (uint32_t)payloadSize);
+    const char* data = reinterpret_cast<const char*>(payload);
+    const int frameSize = headerSize + payloadSize;
+    int totalBytesSent = 0;
+    while (totalBytesSent < frameSize)
+    {
+        SocketBuffer buffers[2];
+        int numberOfBuffers = 0;
+        if (totalBytesSent < headerSize)
+        {
+            buffers[numberOfBuffers++] = makeSocketBuffer(header + totalBytesSent, headerSize - totalBytesSent);
+        }
+        const int payloadOffset = totalBytesSent < headerSize ? 0 : totalBytesSent - headerSize;
+        if (payloadOffset < payloadSize)
+        {
+            buffers[numberOfBuffers++] = makeSocketBuffer(data + payloadOffset, payloadSize - payloadOffset);
+        }
+        int bytesSent = 0;
+        Result result = sendv(buffers, numberOfBuffers, bytesSent);
+        if (result != Result::success)
+        {
+            return Result::genericError;
+        }
+        totalBytesSent += bytesSent;
+    }
+    return Result::success;
 }
 
 Result Socket::sendBroadcast(const void* data, int numberOfBytes, int& bytesSent, unsigned short port)
@@ -176,7 +236,7 @@ Result Socket::sendAllBroadcast(const void* data, int numberOfBytes, unsigned sh
         int bytesRemaining = numberOfBytes - totalBytesSent;
         int bytesSent = 0;
         const char* bufferOffset = reinterpret_cast<const char*>(data) + totalBytesSent;
-        Result result = sendBroadcast(bufferOffset, numberOfBytes, bytesSent, port);
+        Result result = sendBroadcast(bufferOffset, bytesRemaining, bytesSent, port);
         if (result != Result::success)
         {
             return Result::genericError;
@@ -196,10 +256,10 @@ Result Socket::sendJsonBroadcast(const Json& jsonData, unsigned short port)
 Result Socket::sendTo(const void* data, int numberOfBytes, int& bytesSent, IPEndpoint endpoint)
 {
     sockaddr_in addr = endpoint.getSockaddrIPv4();
-    bytesSent = ::sendto(handle, reinterpret_cast<const char*>(data), numberOfBytes, NULL, reinterpret_cast<sockaddr*>(&addr), sizeof(sockaddr_in));
+    bytesSent = ::sendto(handle, reinterpret_cast<const char*>(data), numberOfBytes, 0, reinterpret_cast<sockaddr*>(&addr), sizeof(sockaddr_in));
     if (bytesSent == SOCKET_ERROR)
     {
-        return errorCodeToResult(WSAGetLastError());
+        return errorCodeToResult(lastSocketError());
     }
     return Result::success;
 }
@@ -212,7 +272,7 @@ Result Socket::sendAllTo(const void* data, int numberOfBytes, IPEndpoint endpoin
         int bytesRemaining = numberOfBytes - totalBytesSent;
         int bytesSent = 0;
         const char* bufferOffset = reinterpret_cast<const char*>(data) + totalBytesSent;
-        Result result = sendTo(bufferOffset, numberOfBytes, bytesSent, endpoint);
+        Result result = sendTo(bufferOffset, bytesRemaining, bytesSent, endpoint);
         if (result != Result::success)
         {
             return Result::genericError;
@@ -232,14 +292,14 @@ Result Socket::sendJsonTo(const Json& jsonData, IPEndpoint endpoint)
 
 Result Socket::recieve(void* destination, int numberOfBytes, int& bytesRecieved)
 {
-    bytesRecieved = recv(handle, reinterpret_cast<char*>(destination), numberOfBytes, NULL);
+    bytesRecieved = recv(handle, reinterpret_cast<char*>(destination), numberOfBytes, 0);
     if (bytesRecieved == 0)
     {
         return Result::genericError;
     }
     if (bytesRecieved == SOCKET_ERROR)
     {
-        int errorCode = WSAGetLastError();
+        int errorCode = lastSocketError();
         return errorCodeToResult(errorCode);
     }
     return Result::success;
@@ -247,17 +307,46 @@ Result Socket::recieve(void* destination, int numberOfBytes, int& bytesRecieved)
 
 Result Socket::recieveJson(Json& jsonDestination)
 {
-    std::string buffer;
-    int bytesRecieved;
-    buffer.resize(1024);
-    Result result = recieve(&buffer[0], 1024, bytesRecieved);
-    if (result == Result::success)
+    std::string payload;
+    Result result = recieveFrame(payload);
+    if (result != Result::success)
     {
-        std::istringstream oss(buffer);
-        oss >> jsonDestination;
-        return Result::success;
+        return result;
+    }
+    jsonDestination = Json::parse(payload, nullptr, false);
+    if (jsonDestination.is_discarded())
+    {
+        return Result::genericError;
+    }
+    return Result::success;
+}
+
+Result Socket::recieveFrame(std::string& payload)
+{
+    while (true)
+    {
+        const char* framePayload = nullptr;
+        uint32_t payloadSize = 0;
+        Result result = peekFrame(recieveBuffer.c_str(), recieveBuffer.size(), framePayload, payloadSize);
+        if (result == Result::success)
+        {
+            payload.assign(framePayload, payloadSize);
+            recieveBuffer.erase(0, FRAME_HEADER_SIZE + payloadSize);
+            return Result::success;
+        }
+        if (result != Result::wouldBlock)
+        {
+            return result;
+        }
+        char buffer[4096];
+        int bytesRecieved = 0;
+        result = recieve(buffer, sizeof(buffer), bytesRecieved);
+        if (result != Result::success)
+        {
+            return result;
+        }
+        recieveBuffer.append(buffer, bytesRecieved);
     }
-    return result;
 }
 
 
@@ -270,7 +359,11 @@ Result Socket::recieveTime(unsigned long long& time)
     if (result == Result::success)
     {
         std::memcpy(&time, &buffer[16], sizeof(unsigned long long));
+#ifdef __linux__
+        time = __builtin_bswap64(time) / 10000000000;
+#else
         time = _byteswap_uint64(time) / 10000000000;
+#endif
         return Result::success;
     }
     return result;
@@ -285,7 +378,7 @@ Result Socket::recieveAll(void* destination, int numberOfBytes)
         int bytesRemaining = numberOfBytes - totalBytesRecieved;
         int bytesRecieved = 0;
         char* bufferOffset = reinterpret_cast<char*>(destination) + totalBytesRecieved;
-        Result result = recieve(bufferOffset, numberOfBytes, bytesRecieved);
+        Result result = recieve(bufferOffset, bytesRemaining, bytesRecieved);
         if (result != Result::success)
         {
             return result;
@@ -297,15 +390,14 @@ Result Socket::recieveAll(void* destination, int numberOfBytes)
 
 Result Socket::getIPEndpoint(IPEndpoint& ipEndpoint) const
 {
-    sockaddr addr;
-    int addrLen = sizeof(sockaddr_in);
-    int result = getsockname(handle, &addr, &addrLen);
+    sockaddr_storage addr = {};
+    SocketLength addrLen = sizeof(addr);
+    int result = getsockname(handle, reinterpret_cast<sockaddr*>(&addr), &addrLen);
     if (result != 0)
     {
-        int error = WSAGetLastError();
         return Result::genericError;
     }
-    ipEndpoint = IPEndpoint(&addr);
+    ipEndpoint = IPEndpoint(reinterpret_cast<sockaddr*>(&addr));
     return Result::success;
 }
 
@@ -351,6 +443,9 @@ Result Socket::setSocketOption(SocketOption option, BOOL value)
     case SocketOption::SO_Broadcast:
         result = setsockopt(handle, SOL_SOCKET, SO_BROADCAST, reinterpret_cast<const char*>(&value), sizeof(value));
         break;
+    case SocketOption::SO_ReuseAddress:
+        result = setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&value), sizeof(value));
+        break;
     default:
         return Result::genericError;
     }
@@ -368,8 +463,17 @@ Result Socket::setSocketOption(SocketOption option, DWORD value)
     switch (option)
     {
     case SocketOption::SO_RecieveTimeout:
+    {
+#ifdef __linux__
+        timeval timeout = {};
+        timeout.tv_sec = time_t(value / 1000);
+        timeout.tv_usec = suseconds_t(value % 1000 * 1000);
+        result = setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#else
         result = setsockopt(handle, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&value), sizeof(value));
+#endif
         break;
+    }
     default:
         return Result::genericError;
     }
@@ -387,8 +491,15 @@ Result Socket::setIOMode(IOMode mode, unsigned long arg)
     switch (mode)
     {
     case IOMode::fionbio:
+    {
+#ifdef __linux__
+        const int flags = fcntl(handle, F_GETFL, 0);
+        result = flags == -1 ? -1 : fcntl(handle, F_SETFL, arg ? flags | O_NONBLOCK : flags & ~O_NONBLOCK);
+#else
         result = ioctlsocket(handle, FIONBIO, &arg);
+#endif
         break;
+    }
     default:
         return Result::genericError;
     }
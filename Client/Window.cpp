@@ -117,6 +117,7 @@ void Window::SetUsersRoomsControlsVisibilty(bool visible)
 	int command = visible ? SW_SHOW : SW_HIDE;
 	ShowWindow(createButton, command);
 	ShowWindow(joinButton, command);
+	ShowWindow(moreButton, command);
 	ShowWindow(roomsText, command);
 	ShowWindow(roomsList, command);
 	ShowWindow(usersText, command);
@@ -137,8 +138,6 @@ void Window::HandleDisconnection()
 {
 	SetWindowText(connectButton, "connect");
 	SetUsersRoomsControlsVisibilty(false);
-	RemoveAllUsers();
-	RemoveAllRooms();
 }
 
 void Window::HandleServerConfig(const Json& message)
@@ -151,6 +150,8 @@ void Window::HandleUserList(const Json& message)
 {
 	std::vector<std::string> roomIds = message["roomIds"];
 	std::vector<std::string> names = message["names"];
+	// the lists replace whatever the lobby view held before, a resumed session never gets them
+	RemoveAllUsers();
 	for (size_t i = 0; i < roomIds.size(); ++i)
 	{
 		AddUser(roomIds[i], names[i]);
@@ -187,10 +188,27 @@ void Window::HandleRoomList(const Json& message)
 	std::vector<std::string> hosts = message["hosts"];
 	std::vector<std::string> guests = message["guests"];
 	std::vector<bool> locks = message["locks"];
+	RemoveAllRooms();
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		AddRoom(ids[i], hosts[i], guests[i], locks[i]);
+	}
+}
+
+void Window::HandleRoomsPage(const Json& message)
+{
+	std::vector<std::string> ids = message["ids"];
+	std::vector<std::string> hosts = message["hosts"];
+	std::vector<std::string> guests = message["guests"];
+	std::vector<bool> locks = message["locks"];
+	RemoveAllRooms();
 	for (size_t i = 0; i < ids.size(); ++i)
 	{
 		AddRoom(ids[i], hosts[i], guests[i], locks[i]);
 	}
+	// after the last page the button starts over from the first one
+	nextRoomsCursor = message["cursor"];
+	SetWindowText(moreButton, nextRoomsCursor == "0" ? "first" : "more");
 }
 
 void Window::HandleAddRoom(const Json& message)
@@ -207,38 +225,57 @@ void Window::HandleRoomChange(const Json& message)
 {
 	std::string id = message["roomId"];
 	int ind = FindRoom(id);
-	if (ind != -1)
+	// the player's own room may lie outside the page, its changes still reach the room controls
+	bool ownRoom = std::atoi(id.c_str()) == roomId;
+	if (ind == -1 && !ownRoom)
 	{
-		std::string change = message["change"];
-		if (change == "host")
+		return;
+	}
+	std::string change = message["change"];
+	if (change == "host")
+	{
+		if (ind != -1)
 		{
 			ChangeRoomHost(ind, message["host"]);
-			if (std::atoi(id.c_str()) == roomId && !isHost)
-			{
-				std::string text = "host: " + std::string(message["host"]);
-				SetWindowText(firstPlayerText, text.c_str());
-				text = "guest:";
-				SetWindowText(secondPlayerText, text.c_str());
-				isHost = true;
-				SetRoomControl(true);
-			}
 		}
-		else if (change == "guest")
+		if (ownRoom && !isHost)
+		{
+			std::string text = "host: " + std::string(message["host"]);
+			SetWindowText(firstPlayerText, text.c_str());
+			text = "guest:";
+			SetWindowText(secondPlayerText, text.c_str());
+			isHost = true;
+			SetRoomControl(true);
+		}
+	}
+	else if (change == "guest")
+	{
+		if (ind != -1)
 		{
 			SetRoomGuest(ind, message["guest"]);
-			if (std::atoi(id.c_str()) == roomId)
-			{
-				std::string text = "guest: " + std::string(message["guest"]);
-				SetWindowText(secondPlayerText, text.c_str());
-			}
 		}
-		else if (change == "lock")
+		if (ownRoom)
+		{
+			std::string text = "guest: " + std::string(message["guest"]);
+			SetWindowText(secondPlayerText, text.c_str());
+		}
+	}
+	else if (change == "lock")
+	{
+		if (ind != -1)
 		{
 			SetRoomLock(ind, message["lock"]);
-			if (std::atoi(id.c_str()) == roomId)
-			{
-				SetRoomLock(message["lock"]);
-			}
+		}
+		if (ownRoom)
+		{
+			SetRoomLock(message["lock"]);
+		}
+	}
+	else if (change == "difficulty")
+	{
+		if (ownRoom)
+		{
+			SetRoomDifficulty(message["difficulty"]);
 		}
 	}
 }
@@ -264,11 +301,89 @@ void Window::HandleJoin(const Json& message)
 void Window::HandleQuit(const Json& message)
 {
 	roomId = 0;
+	ready = false;
+	SetSudoku("");
 	SetRoomControlsVisibility(false);
 	SetConnectionControlsVisibilty(true);
 	SetUsersRoomsControlsVisibilty(true);
 }
 
+void Window::HandleStart(const Json& message)
+{
+	SetRoomDifficulty(message["difficulty"]);
+	std::string puzzle = message["puzzle"];
+	SetSudoku(puzzle);
+	SetPlayerScore("host", 0, message["lifes"]);
+	SetPlayerScore("guest", 0, message["lifes"]);
+	ready = false;
+	SetWindowText(readyButton, "READY");
+}
+
+void Window::HandleReady(const Json& message)
+{
+	if ((message["as"] == "host") == isHost)
+	{
+		ready = message["ready"];
+		SetWindowText(readyButton, ready ? "NOT READY" : "READY");
+	}
+}
+
+void Window::HandleMove(const Json& message)
+{
+	SetPlayerScore(message["as"], message["points"], message["lifes"]);
+	if (!message.contains("digit"))
+	{
+		return;
+	}
+	int cell = message["cell"];
+	int digit = message["digit"];
+	if (message["correct"])
+	{
+		board.Place(cell, digit);
+		confirmed.set(cell);
+		hinted.reset();
+	}
+	else if (board.Get(cell) == digit)
+	{
+		board.Erase(cell);
+	}
+	InvalidateRect(sudoku, NULL, true);
+}
+
+void Window::HandleHint(const Json& message)
+{
+	SetPlayerScore(message["as"], message["points"], message["lifes"]);
+	if (message.contains("reason"))
+	{
+		std::string reason = message["reason"];
+		SetWindowText(hintText, reason.c_str());
+	}
+	if (!message.contains("cell"))
+	{
+		return;
+	}
+	std::string technique = message["technique"];
+	std::string text = technique + ": " + std::to_string(int(message["digit"]));
+	SetWindowText(hintText, text.c_str());
+	hinted.reset();
+	for (int cell : message["cells"])
+	{
+		hinted.set(cell);
+	}
+	selectedCell = message["cell"];
+	InvalidateRect(sudoku, NULL, true);
+}
+
+void Window::HandleFinish(const Json& message)
+{
+	std::string winner = message["winner"];
+	selectedCell = -1;
+	InvalidateRect(sudoku, NULL, true);
+	std::string text = "winner: " + winner;
+	SetWindowText(readyButton, text.c_str());
+	ready = false;
+}
+
 Window::~Window()
 {
 	DestroyConnectionControls();
@@ -312,11 +427,24 @@ LRESULT Window::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		return 0;
 	case WM_KILLFOCUS:
 		break;
+	case WM_CHAR:
+		if (roomControlsVisible && selectedCell >= 0)
+		{
+			if (wParam >= '1' && wParam <= '9')
+			{
+				EnterDigit(int(wParam - '0'));
+			}
+			else if ((wParam == '0' || wParam == VK_BACK) && !confirmed[selectedCell])
+			{
+				board.Erase(selectedCell);
+				InvalidateRect(sudoku, NULL, true);
+			}
+		}
+		break;
 	/********** KEYBOARD MESSAGES **********/
 	case WM_KEYDOWN:
 	case WM_KEYUP:
 	case WM_SYSKEYUP:
-	case WM_CHAR:
 	case WM_SYSCHAR:
 	/********** END KEYBOARD MESSAGES **********/
 
@@ -368,6 +496,14 @@ LRESULT Window::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			message["roomId"] = selectedRoomId;
 			client.sendMessage(message);
 		}
+		else if ((HWND)lParam == moreButton)
+		{
+			Json message;
+			message["type"] = "listRooms";
+			message["cursor"] = nextRoomsCursor;
+			message["limit"] = Client::ROOMS_PAGE_SIZE;
+			client.sendMessage(message);
+		}
 		else if ((HWND)lParam == lockButton)
 		{
 			if (isHost)
@@ -387,7 +523,34 @@ LRESULT Window::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		}
 		else if ((HWND)lParam == difficultyCombobox)
 		{
-
+			if (isHost && HIWORD(wParam) == CBN_SELCHANGE)
+			{
+				Json message;
+				message["type"] = "changeRoom";
+				message["change"] = "difficulty";
+				message["difficulty"] = ComboBox_GetCurSel(difficultyCombobox);
+				client.sendMessage(message);
+			}
+		}
+		else if ((HWND)lParam == sudoku)
+		{
+			if (HIWORD(wParam) == STN_CLICKED)
+			{
+				SelectSudokuCell();
+			}
+		}
+		else if ((HWND)lParam == hintButton)
+		{
+			Json message;
+			message["type"] = "hint";
+			client.sendMessage(message);
+		}
+		else if ((HWND)lParam == readyButton)
+		{
+			Json message;
+			message["type"] = "ready";
+			message["ready"] = !ready;
+			client.sendMessage(message);
 		}
 		break;
 	case WM_NOTIFY:
@@ -416,6 +579,16 @@ LRESULT Window::WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		}
 		break;
 	}
+	case WM_DRAWITEM:
+	{
+		const DRAWITEMSTRUCT* item = (const DRAWITEMSTRUCT*)lParam;
+		if (item->hwndItem == sudoku)
+		{
+			DrawSudoku(*item);
+			return true;
+		}
+		break;
+	}
 	case WM_CTLCOLORSTATIC:
 	{
 		HDC hdc = (HDC)wParam;
@@ -522,6 +695,7 @@ void Window::CreateUsersRoomsControls()
 
 	createButton = CreateButton("create");
 	joinButton = CreateButton("join");
+	moreButton = CreateButton("first");
 	roomsText = CreateText("rooms");
 	roomsList = CreateRoomsList();
 	usersText = CreateText("users");
@@ -544,6 +718,9 @@ void Window::SetUsersRoomsControlsLayout()
 	// join button
 	SetWindowPos(joinButton, NULL, 10+roomsListWidth-roomsListWidth/5, 60, roomsListWidth/5, 20, 0);
 
+	// more button
+	SetWindowPos(moreButton, NULL, 10+roomsListWidth-2*(roomsListWidth/5)-10, 60, roomsListWidth/5, 20, 0);
+
 	// rooms text
 	SetWindowPos(roomsText, NULL, 10+roomsListWidth/2-21, 60, 42, 20, 0);
 	
@@ -569,6 +746,7 @@ void Window::DestroyUsersRoomsControls()
 {
 	DestroyWindow(createButton);
 	DestroyWindow(joinButton);
+	DestroyWindow(moreButton);
 	DestroyWindow(roomsText);
 	DestroyWindow(roomsList);
 	DestroyWindow(usersText);
@@ -637,10 +815,6 @@ void Window::AddRoom(const std::string& id, const std::string& host, const std::
 		lvi.iSubItem = 4;
 		ListView_SetItem(roomsList, &lvi);
 	}
-	if (ListView_GetItemCount(roomsList) == serverConfig["MAX_NUMBER_OF_ROOMS"])
-	{
-		EnableWindow(createButton, false);
-	}
 }
 
 void Window::RemoveRoom(const std::string& id)
@@ -649,7 +823,6 @@ void Window::RemoveRoom(const std::string& id)
 	if (ind != -1)
 	{
 		ListView_DeleteItem(roomsList, ind);
-		EnableWindow(createButton, true);
 	}
 }
 
@@ -766,6 +939,8 @@ void Window::CreateRoomControls()
 	secondPlayerPoints = CreateText("points:");
 	secondPlayerLifes = CreateText("lifes:");
 	kickButton = CreateButton("kick");
+	hintButton = CreateButton("hint");
+	hintText = CreateText("");
 	readyButton = CreateButton("READY");
 	SetRoomControlsLayout();
 }
@@ -786,6 +961,8 @@ void Window::SetRoomControlsLayout()
 	SetWindowPos(secondPlayerPoints, NULL, sudokuX+sudokuSize+10, 260, 210, 20, 0);
 	SetWindowPos(secondPlayerLifes, NULL, sudokuX+sudokuSize+10, 290, 210, 20, 0);
 	SetWindowPos(kickButton, NULL, sudokuX+sudokuSize+10, 320, 210, 20, 0);
+	SetWindowPos(hintButton, NULL, sudokuX+sudokuSize+10, 350, 210, 20, 0);
+	SetWindowPos(hintText, NULL, sudokuX+sudokuSize+10, 380, 210, 40, 0);
 	SetWindowPos(readyButton, NULL, sudokuX + sudokuSize + 10, 10+sudokuSize-50, 210, 50, 0);
 }
 
@@ -805,6 +982,8 @@ void Window::SetRoomControlsVisibility(bool visible)
 	ShowWindow(secondPlayerPoints, command);
 	ShowWindow(secondPlayerLifes, command);
 	ShowWindow(kickButton, command);
+	ShowWindow(hintButton, command);
+	ShowWindow(hintText, command);
 	ShowWindow(readyButton, command);
 	SetRoomControlsLayout();
 	InvalidateRect(hWnd, NULL, true);
@@ -826,6 +1005,8 @@ void Window::DestroyRoomControls()
 	DestroyWindow(secondPlayerPoints);
 	DestroyWindow(secondPlayerLifes);
 	DestroyWindow(kickButton);
+	DestroyWindow(hintButton);
+	DestroyWindow(hintText);
 	DestroyWindow(readyButton);
 }
 
@@ -847,6 +1028,129 @@ void Window::SetRoomDifficulty(int difficulty)
 	ComboBox_SetCurSel(difficultyCombobox, difficulty);
 }
 
+void Window::SetPlayerScore(const std::string& as, int points, int lifes)
+{
+	std::string text = "points: " + std::to_string(points);
+	SetWindowText(as == "host" ? firstPlayerPoints : secondPlayerPoints, text.c_str());
+	text = "lifes: " + std::to_string(lifes);
+	SetWindowText(as == "host" ? firstPlayerLifes : secondPlayerLifes, text.c_str());
+}
+
+void Window::SetSudoku(const std::string& puzzle)
+{
+	board.Load(puzzle);
+	confirmed.reset();
+	hinted.reset();
+	selectedCell = -1;
+	SetWindowText(hintText, "");
+	InvalidateRect(sudoku, NULL, true);
+}
+
+void Window::SelectSudokuCell()
+{
+	POINT cursorPos;
+	GetCursorPos(&cursorPos);
+	ScreenToClient(sudoku, &cursorPos);
+	RECT rect;
+	GetClientRect(sudoku, &rect);
+	const int row = cursorPos.y * LiveBoard::SIZE / max(rect.bottom, 1L);
+	const int column = cursorPos.x * LiveBoard::SIZE / max(rect.right, 1L);
+	if (row >= 0 && row < LiveBoard::SIZE && column >= 0 && column < LiveBoard::SIZE)
+	{
+		selectedCell = row * LiveBoard::SIZE + column;
+		InvalidateRect(sudoku, NULL, true);
+	}
+	// the static control never keeps the focus, digits arrive through the main window
+	SetFocus(hWnd);
+}
+
+void Window::EnterDigit(int digit)
+{
+	if (board.IsGiven(selectedCell) || confirmed[selectedCell] || !board.Place(selectedCell, digit))
+	{
+		return;
+	}
+	InvalidateRect(sudoku, NULL, true);
+	Json message;
+	message["type"] = "placeDigit";
+	message["cell"] = selectedCell;
+	message["digit"] = digit;
+	client.sendMessage(message);
+}
+
+void Window::DrawSudoku(const DRAWITEMSTRUCT& item) const
+{
+	HDC hdc = item.hDC;
+	const RECT& rect = item.rcItem;
+	FillRect(hdc, &rect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+	const int cellWidth = (rect.right - rect.left) / LiveBoard::SIZE;
+	const int cellHeight = (rect.bottom - rect.top) / LiveBoard::SIZE;
+	HBRUSH hintBrush = CreateSolidBrush(RGB(255, 245, 200));
+	for (int cell = 0; cell < LiveBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		if (hinted[cell])
+		{
+			RECT cellRect;
+			cellRect.left = rect.left + cell % LiveBoard::SIZE * cellWidth;
+			cellRect.top = rect.top + cell / LiveBoard::SIZE * cellHeight;
+			cellRect.right = cellRect.left + cellWidth;
+			cellRect.bottom = cellRect.top + cellHeight;
+			FillRect(hdc, &cellRect, hintBrush);
+		}
+	}
+	DeleteObject(hintBrush);
+	if (selectedCell >= 0)
+	{
+		RECT cellRect;
+		cellRect.left = rect.left + selectedCell % LiveBoard::SIZE * cellWidth;
+		cellRect.top = rect.top + selectedCell / LiveBoard::SIZE * cellHeight;
+		cellRect.right = cellRect.left + cellWidth;
+		cellRect.bottom = cellRect.top + cellHeight;
+		HBRUSH brush = CreateSolidBrush(RGB(220, 235, 255));
+		FillRect(hdc, &cellRect, brush);
+		DeleteObject(brush);
+	}
+	SetBkMode(hdc, TRANSPARENT);
+	for (int cell = 0; cell < LiveBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		const int digit = board.Get(cell);
+		if (!digit)
+		{
+			continue;
+		}
+		if (board.HasConflict(cell))
+		{
+			SetTextColor(hdc, RGB(200, 0, 0));
+		}
+		else if (board.IsGiven(cell))
+		{
+			SetTextColor(hdc, RGB(0, 0, 0));
+		}
+		else
+		{
+			SetTextColor(hdc, confirmed[cell] ? RGB(0, 0, 200) : RGB(128, 128, 128));
+		}
+		RECT cellRect;
+		cellRect.left = rect.left + cell % LiveBoard::SIZE * cellWidth;
+		cellRect.top = rect.top + cell / LiveBoard::SIZE * cellHeight;
+		cellRect.right = cellRect.left + cellWidth;
+		cellRect.bottom = cellRect.top + cellHeight;
+		const char text[] = { char('0' + digit), '\0' };
+		DrawText(hdc, text, 1, &cellRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+	}
+	for (int line = 1; line < LiveBoard::SIZE; ++line)
+	{
+		HPEN pen = CreatePen(PS_SOLID, line % 3 == 0 ? 3 : 1, RGB(0, 0, 0));
+		HGDIOBJ oldPen = SelectObject(hdc, pen);
+		MoveToEx(hdc, rect.left + line * cellWidth, rect.top, NULL);
+		LineTo(hdc, rect.left + line * cellWidth, rect.bottom);
+		MoveToEx(hdc, rect.left, rect.top + line * cellHeight, NULL);
+		LineTo(hdc, rect.right, rect.top + line * cellHeight);
+		SelectObject(hdc, oldPen);
+		DeleteObject(pen);
+	}
+}
+
 HWND Window::CreateText(const std::string& text)
 {
 	HWND hText = CreateWindow(
@@ -1027,7 +1331,7 @@ HWND Window::CreateSudoku()
 	HWND sudoku = CreateWindow(
 		"STATIC",
 		"",
-		WS_CHILD | WS_BORDER | BS_DEFPUSHBUTTON,
+		WS_CHILD | WS_BORDER | SS_OWNERDRAW | SS_NOTIFY,
 		0, 0, 0, 0,
 		hWnd,
 		NULL,
@@ -2,6 +2,8 @@
 #include "LeanWindows.h"
 #include "BaseException.h"
 #include "Client.h"
+#include "LiveBoard.h"
+#include <bitset>
 #include <optional>
 
 class Window
@@ -58,11 +60,17 @@ public:
 	void HandleRemoveUser(const Json& message);
 	void HandeChangeUser(const Json& message);
 	void HandleRoomList(const Json& message);
+	void HandleRoomsPage(const Json& message);
 	void HandleAddRoom(const Json& message);
 	void HandleRemoveRoom(const Json& message);
 	void HandleRoomChange(const Json& message);
 	void HandleJoin(const Json& message);
 	void HandleQuit(const Json& message);
+	void HandleStart(const Json& message);
+	void HandleReady(const Json& message);
+	void HandleMove(const Json& message);
+	void HandleHint(const Json& message);
+	void HandleFinish(const Json& message);
 	~Window();
 private:
 	static LRESULT CALLBACK SetupWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -98,6 +106,11 @@ private:
 	void SetRoomControl(bool hasControl);
 	void SetRoomLock(bool locked);
 	void SetRoomDifficulty(int difficulty);
+	void SetSudoku(const std::string& puzzle);
+	void SetPlayerScore(const std::string& as, int points, int lifes);
+	void SelectSudokuCell();
+	void EnterDigit(int digit);
+	void DrawSudoku(const DRAWITEMSTRUCT& item) const;
 	// helpers
 	HWND CreateText(const std::string& text);
 	HWND CreateEdit(const std::string& text);
@@ -123,12 +136,14 @@ private:
 	// rooms/users controls
 	HWND createButton;
 	HWND joinButton;
+	HWND moreButton;
 	HWND roomsText;
 	HWND roomsList;
 	HWND usersText;
 	HWND usersList;
 	bool roomUsersControlsVisible = false;
 	int selectedRoomId = 0;
+	std::string nextRoomsCursor = "0";
 	// room controls
 	HWND sudoku;
 	HWND quitButton;
@@ -144,8 +159,17 @@ private:
 	HWND secondPlayerPoints;
 	HWND secondPlayerLifes;
 	HWND kickButton;
+	HWND hintButton;
+	HWND hintText;
 	HWND readyButton;
 	int roomId = 0;
+	LiveBoard board;
+	// digits the server accepted, the rest are still waiting for a reply
+	std::bitset<LiveBoard::NUMBER_OF_CELLS> confirmed;
+	// cells the last hint's deduction is built on
+	std::bitset<LiveBoard::NUMBER_OF_CELLS> hinted;
+	int selectedCell = -1;
+	bool ready = false;
 	bool roomLocked = false;
 	bool roomControlsVisible = false;
 	bool isHost;
@@ -0,0 +1,442 @@
+#include "Bot.h"
+#include "BotGroup.h"
+#include "MessageFrame.h"
+#include "SudokuGrader.h"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace
+{
+	constexpr const MessageType ACTION_MESSAGES[] = { MessageType::connect, MessageType::createRoom, MessageType::join,
+		MessageType::lock, MessageType::quit, MessageType::changeRoom };
+	static_assert(sizeof(ACTION_MESSAGES) / sizeof(*ACTION_MESSAGES) == size_t(Action::count), "missing action message");
+}
+
+int toRoomId(const Json& value)
+{
+	// room ids travel as strings, only the join reply carries a number
+	return value.is_string() ? std::stoi(value.get<std::string>()) : value.get<int>();
+}
+
+Bot::Bot(BotGroup& group, std::string name, bool observer)
+	: group(&group), name(std::move(name)), observer(observer)
+{
+}
+
+Bot::~Bot()
+{
+	Disconnect();
+}
+
+void Bot::Schedule(Clock::time_point at)
+{
+	nextActionAt = at;
+}
+
+void Bot::Tick(Clock::time_point now)
+{
+	if (pending != NO_ACTION && now - sentAt >= group->GetScenario().responseTimeout)
+	{
+		++group->GetStatistics().timeouts[size_t(pending)];
+		if (pending == Action::connect)
+		{
+			Drop(now);
+			return;
+		}
+		pending = NO_ACTION;
+		Think(now);
+	}
+	if (pending != NO_ACTION || now < nextActionAt)
+	{
+		return;
+	}
+	if (state == BotState::offline)
+	{
+		Connect(now);
+	}
+	else if ((state == BotState::lobby || state == BotState::room) && !observer)
+	{
+		Act(now);
+	}
+}
+
+void Bot::OnReadable(Clock::time_point now)
+{
+	char buffer[64 * 1024];
+	for (;;)
+	{
+		const ssize_t received = recv(socket, buffer, sizeof(buffer), 0);
+		if (received > 0)
+		{
+			inbound.append(buffer, size_t(received));
+			group->GetStatistics().bytes += uint64_t(received);
+			continue;
+		}
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		Drop(now);
+		return;
+	}
+	size_t offset = 0;
+	const char* payload = nullptr;
+	uint32_t payloadSize = 0;
+	Result result;
+	while ((result = peekFrame(inbound.data() + offset, inbound.size() - offset, payload, payloadSize)) == Result::success)
+	{
+		offset += FRAME_HEADER_SIZE + payloadSize;
+		HandleMessage(payload, payloadSize, now);
+		if (socket < 0)
+		{
+			return;
+		}
+	}
+	if (result == Result::genericError)
+	{
+		Drop(now);
+		return;
+	}
+	inbound.erase(0, offset);
+}
+
+void Bot::OnWritable(Clock::time_point now)
+{
+	if (state != BotState::connecting)
+	{
+		Flush();
+		return;
+	}
+	int error = 0;
+	socklen_t size = sizeof(error);
+	if (getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &size) != 0 || error != 0)
+	{
+		++group->GetStatistics().connectFailures;
+		Drop(now);
+		return;
+	}
+	// the request that negotiates the encoding is always json
+	Json request;
+	request["type"] = "connect";
+	request["name"] = name;
+	request["encoding"] = toString(group->GetScenario().encoding);
+	state = BotState::handshaking;
+	Send(request);
+}
+
+void Bot::Disconnect()
+{
+	if (socket >= 0)
+	{
+		close(socket);
+		socket = -1;
+	}
+	state = BotState::offline;
+	encoding = Encoding::json;
+	inbound.clear();
+	outbound.clear();
+	waitingForWrite = false;
+	roomId = 0;
+	host = false;
+	pending = NO_ACTION;
+}
+
+int Bot::GetSocket() const
+{
+	return socket;
+}
+
+BotState Bot::GetState() const
+{
+	return state;
+}
+
+void Bot::Connect(Clock::time_point now)
+{
+	++group->GetStatistics().sent[size_t(Action::connect)];
+	pending = Action::connect;
+	sentAt = now;
+	socket = ::socket(group->GetAddress()->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if (socket < 0)
+	{
+		++group->GetStatistics().connectFailures;
+		Drop(now);
+		return;
+	}
+	const int noDelay = 1;
+	setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+	state = BotState::connecting;
+	waitingForWrite = true;
+	if ((connect(socket, group->GetAddress(), group->GetAddressSize()) != 0 && errno != EINPROGRESS) || !group->Watch(*this, false, true))
+	{
+		++group->GetStatistics().connectFailures;
+		Drop(now);
+	}
+}
+
+void Bot::Act(Clock::time_point now)
+{
+	const Scenario& scenario = group->GetScenario();
+	unsigned int total = 0;
+	for (size_t i = 0; i < size_t(Action::count); ++i)
+	{
+		total += IsAvailable(Action(i)) ? scenario.weights[i] : 0;
+	}
+	if (total == 0)
+	{
+		Think(now);
+		return;
+	}
+	unsigned int pick = std::uniform_int_distribution<unsigned int>(0, total - 1)(group->GetRandom());
+	Action action = Action::connect;
+	for (size_t i = 0; i < size_t(Action::count); ++i)
+	{
+		const unsigned int weight = IsAvailable(Action(i)) ? scenario.weights[i] : 0;
+		if (pick < weight)
+		{
+			action = Action(i);
+			break;
+		}
+		pick -= weight;
+	}
+	if (action == Action::connect)
+	{
+		// reconnecting measures a whole session setup, from the tcp handshake to the rooms list
+		Disconnect();
+		Connect(now);
+		return;
+	}
+	MessageWriter message(encoding, ACTION_MESSAGES[size_t(action)]);
+	switch (action)
+	{
+	case Action::join:
+		message.Integer(Field::roomId, group->GetLobby().PickOpenRoom(group->GetRandom()));
+		break;
+	case Action::lock:
+		message.Boolean(Field::lock, !locked);
+		break;
+	case Action::changeRoom:
+		message.String(Field::change, "difficulty")
+			.Integer(Field::difficulty, (difficulty + 1) % int(Difficulty::count));
+		break;
+	default:
+		break;
+	}
+	++group->GetStatistics().sent[size_t(action)];
+	pending = action;
+	sentAt = now;
+	Send(message);
+}
+
+bool Bot::IsAvailable(Action action) const
+{
+	switch (action)
+	{
+	case Action::connect:
+		return true;
+	case Action::createRoom:
+		return state == BotState::lobby;
+	case Action::join:
+		return state == BotState::lobby && group->GetLobby().HasOpenRoom();
+	case Action::lock:
+	case Action::changeRoom:
+		return state == BotState::room && host;
+	case Action::quit:
+		return state == BotState::room;
+	default:
+		return false;
+	}
+}
+
+void Bot::Send(MessageWriter& message)
+{
+	const std::string& payload = message.Finish();
+	appendFrameHeader(outbound, uint32_t(payload.size()));
+	outbound.append(payload);
+	Flush();
+}
+
+void Bot::Send(const Json& message)
+{
+	const std::string payload = encodeMessage(message, Encoding::json);
+	appendFrameHeader(outbound, uint32_t(payload.size()));
+	outbound.append(payload);
+	Flush();
+}
+
+void Bot::Flush()
+{
+	size_t offset = 0;
+	while (offset < outbound.size())
+	{
+		const ssize_t sent = send(socket, outbound.data() + offset, outbound.size() - offset, MSG_NOSIGNAL);
+		if (sent > 0)
+		{
+			offset += size_t(sent);
+		}
+		else if (sent < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			break;
+		}
+		else
+		{
+			Drop(Clock::now());
+			return;
+		}
+	}
+	outbound.erase(0, offset);
+	const bool writable = !outbound.empty();
+	if (writable != waitingForWrite)
+	{
+		waitingForWrite = writable;
+		group->Watch(*this, true, writable);
+	}
+}
+
+void Bot::HandleMessage(const char* payload, uint32_t size, Clock::time_point now)
+{
+	LoadStatistics& statistics = group->GetStatistics();
+	++statistics.messages;
+	// in the binary encoding most broadcasts are skipped by their type byte, only replies,
+	// changes of the bot's own room and the observer's lobby feed have to be decoded
+	switch (peekMessageType(payload, size, encoding))
+	{
+	case MessageType::addUser:
+	case MessageType::changeUser:
+	case MessageType::removeUser:
+	case MessageType::serverConfig:
+	case MessageType::usersList:
+		return;
+	case MessageType::addRoom:
+	case MessageType::removeRoom:
+		if (!observer)
+		{
+			return;
+		}
+		break;
+	case MessageType::changeRoom:
+		if (!observer && state != BotState::room)
+		{
+			return;
+		}
+		break;
+	default:
+		break;
+	}
+	Json message;
+	MessageType type = MessageType::unknown;
+	if (decodeMessage(payload, size, encoding, message, type) != Result::success)
+	{
+		++statistics.errors;
+		statistics.lastError = "undecodable message";
+		Drop(now);
+		return;
+	}
+	if (observer && (type == MessageType::addRoom || type == MessageType::removeRoom || type == MessageType::changeRoom))
+	{
+		group->GetLobby().Update(message);
+	}
+	switch (type)
+	{
+	case MessageType::connect:
+		encoding = toEncoding(message.value("encoding", "json"));
+		break;
+	case MessageType::error:
+		++statistics.errors;
+		statistics.lastError = message.value("reason", "");
+		if (state == BotState::handshaking)
+		{
+			Drop(now);
+		}
+		break;
+	case MessageType::roomsList:
+		if (state == BotState::handshaking)
+		{
+			state = BotState::lobby;
+			if (observer)
+			{
+				group->GetLobby().Reset(message);
+			}
+			Complete(Action::connect, now);
+		}
+		break;
+	case MessageType::join:
+		state = BotState::room;
+		roomId = toRoomId(message["roomId"]);
+		host = message.value("as", "") == "host";
+		locked = message.value("locked", false);
+		difficulty = message.value("difficulty", 0);
+		Complete(host ? Action::createRoom : Action::join, now);
+		break;
+	case MessageType::quit:
+		state = BotState::lobby;
+		roomId = 0;
+		host = false;
+		Complete(Action::quit, now);
+		break;
+	case MessageType::changeRoom:
+	{
+		if (state != BotState::room || toRoomId(message["roomId"]) != roomId)
+		{
+			break;
+		}
+		const std::string change = message.value("change", "");
+		if (change == "lock")
+		{
+			locked = message.value("lock", false);
+			Complete(Action::lock, now);
+		}
+		else if (change == "difficulty")
+		{
+			difficulty = message.value("difficulty", 0);
+			Complete(Action::changeRoom, now);
+		}
+		else if (change == "host")
+		{
+			host = message.value("host", "") == name;
+		}
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+void Bot::Complete(Action action, Clock::time_point now)
+{
+	if (pending != action)
+	{
+		return;
+	}
+	group->GetStatistics().latencies[size_t(action)].Record(std::chrono::duration_cast<std::chrono::microseconds>(now - sentAt));
+	pending = NO_ACTION;
+	Think(now);
+}
+
+void Bot::Drop(Clock::time_point now)
+{
+	if (state != BotState::offline && state != BotState::connecting)
+	{
+		++group->GetStatistics().disconnects;
+	}
+	Disconnect();
+	Think(now);
+}
+
+void Bot::Think(Clock::time_point now)
+{
+	const Scenario& scenario = group->GetScenario();
+	const auto think = std::uniform_int_distribution<long long>(scenario.minThink.count(), scenario.maxThink.count())(group->GetRandom());
+	nextActionAt = now + std::chrono::milliseconds(think);
+}
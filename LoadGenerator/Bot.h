@@ -0,0 +1,66 @@
+#pragma once
+#include "Scenario.h"
+#include <chrono>
+#include <string>
+
+class BotGroup;
+
+int toRoomId(const Json& value);
+
+using Clock = std::chrono::steady_clock;
+
+enum class BotState : uint8_t
+{
+	offline,
+	connecting,
+	handshaking,
+	lobby,
+	room
+};
+
+// one scripted connection, its state only ever follows what the server reports back so a
+// request that was silently ignored or answered late cannot desynchronize it
+class Bot
+{
+public:
+	Bot(BotGroup& group, std::string name, bool observer);
+	Bot(const Bot&) = delete;
+	Bot& operator=(const Bot&) = delete;
+	~Bot();
+	void Schedule(Clock::time_point at);
+	void Tick(Clock::time_point now);
+	void OnReadable(Clock::time_point now);
+	void OnWritable(Clock::time_point now);
+	void Disconnect();
+	int GetSocket() const;
+	BotState GetState() const;
+private:
+	void Connect(Clock::time_point now);
+	void Act(Clock::time_point now);
+	bool IsAvailable(Action action) const;
+	void Send(MessageWriter& message);
+	void Send(const Json& message);
+	void Flush();
+	void HandleMessage(const char* payload, uint32_t size, Clock::time_point now);
+	void Complete(Action action, Clock::time_point now);
+	void Drop(Clock::time_point now);
+	void Think(Clock::time_point now);
+private:
+	static constexpr const Action NO_ACTION = Action::count;
+	BotGroup* group;
+	std::string name;
+	bool observer;
+	int socket = -1;
+	BotState state = BotState::offline;
+	Encoding encoding = Encoding::json;
+	std::string inbound;
+	std::string outbound;
+	bool waitingForWrite = false;
+	int roomId = 0;
+	bool host = false;
+	bool locked = false;
+	int difficulty = 0;
+	Action pending = NO_ACTION;
+	Clock::time_point sentAt;
+	Clock::time_point nextActionAt;
+};
@@ -0,0 +1,209 @@
+#include "BotGroup.h"
+#include <sys/epoll.h>
+#include <unistd.h>
+
+void LoadStatistics::Merge(const LoadStatistics& other)
+{
+	for (size_t i = 0; i < size_t(Action::count); ++i)
+	{
+		latencies[i].Merge(other.latencies[i]);
+		sent[i] += other.sent[i];
+		timeouts[i] += other.timeouts[i];
+	}
+	connectFailures += other.connectFailures;
+	disconnects += other.disconnects;
+	errors += other.errors;
+	messages += other.messages;
+	bytes += other.bytes;
+	if (!other.lastError.empty())
+	{
+		lastError = other.lastError;
+	}
+}
+
+void Lobby::Reset(const Json& roomsList)
+{
+	rooms.clear();
+	openPositions.clear();
+	open.clear();
+	const Json& ids = roomsList["ids"];
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		RoomView view;
+		view.guest = !roomsList["guests"][i].get<std::string>().empty();
+		view.locked = roomsList["locks"][i].get<bool>();
+		Set(toRoomId(ids[i]), view);
+	}
+}
+
+void Lobby::Update(const Json& message)
+{
+	const MessageType type = toMessageType(message["type"]);
+	if (type == MessageType::addRoom)
+	{
+		RoomView view;
+		view.guest = !message.value("guest", "").empty();
+		view.locked = message.value("locked", false);
+		Set(toRoomId(message["id"]), view);
+	}
+	else if (type == MessageType::removeRoom)
+	{
+		Remove(toRoomId(message["id"]));
+	}
+	else if (type == MessageType::changeRoom)
+	{
+		auto it = rooms.find(toRoomId(message["roomId"]));
+		if (it == rooms.end())
+		{
+			return;
+		}
+		RoomView view = it->second;
+		const std::string change = message.value("change", "");
+		if (change == "guest")
+		{
+			view.guest = !message.value("guest", "").empty();
+		}
+		else if (change == "lock")
+		{
+			view.locked = message.value("lock", false);
+		}
+		else if (change == "host")
+		{
+			// the guest took over the room of a host who left
+			view.guest = false;
+		}
+		Set(it->first, view);
+	}
+}
+
+bool Lobby::HasOpenRoom() const
+{
+	return !open.empty();
+}
+
+int Lobby::PickOpenRoom(std::minstd_rand& random) const
+{
+	return open[std::uniform_int_distribution<size_t>(0, open.size() - 1)(random)];
+}
+
+void Lobby::Set(int roomId, RoomView view)
+{
+	rooms[roomId] = view;
+	SetOpen(roomId, !view.guest && !view.locked);
+}
+
+void Lobby::Remove(int roomId)
+{
+	rooms.erase(roomId);
+	SetOpen(roomId, false);
+}
+
+void Lobby::SetOpen(int roomId, bool isOpen)
+{
+	auto it = openPositions.find(roomId);
+	if (isOpen && it == openPositions.end())
+	{
+		openPositions.emplace(roomId, open.size());
+		open.push_back(roomId);
+	}
+	else if (!isOpen && it != openPositions.end())
+	{
+		open[it->second] = open.back();
+		openPositions[open.back()] = it->second;
+		open.pop_back();
+		openPositions.erase(roomId);
+	}
+}
+
+BotGroup::BotGroup(const Scenario& scenario, const sockaddr_storage& address, socklen_t addressSize, size_t first, size_t stride, uint32_t seed)
+	: scenario(scenario), address(address), addressSize(addressSize), first(first), stride(stride), random(seed)
+{
+	epoll = epoll_create1(EPOLL_CLOEXEC);
+	for (size_t index = first; index < scenario.connections; index += stride)
+	{
+		// the first bot of every group only listens, so the lobby view sees each broadcast once
+		bots.emplace_back(*this, scenario.namePrefix + std::to_string(index), index == first);
+	}
+}
+
+BotGroup::~BotGroup()
+{
+	bots.clear();
+	if (epoll >= 0)
+	{
+		close(epoll);
+	}
+}
+
+void BotGroup::Run(Clock::time_point start, Clock::time_point end)
+{
+	for (size_t i = 0; i < bots.size(); ++i)
+	{
+		const std::chrono::duration<double> offset((first + i * stride) / scenario.connectRate);
+		bots[i].Schedule(start + std::chrono::duration_cast<Clock::duration>(offset));
+	}
+	epoll_event events[MAX_EVENTS];
+	for (Clock::time_point now = Clock::now(); now < end; now = Clock::now())
+	{
+		for (Bot& bot : bots)
+		{
+			bot.Tick(now);
+		}
+		const int numberOfEvents = epoll_wait(epoll, events, MAX_EVENTS, int(TICK.count()));
+		now = Clock::now();
+		for (int i = 0; i < numberOfEvents; ++i)
+		{
+			Bot& bot = *static_cast<Bot*>(events[i].data.ptr);
+			if (events[i].events & EPOLLOUT)
+			{
+				bot.OnWritable(now);
+			}
+			if ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && bot.GetSocket() >= 0)
+			{
+				bot.OnReadable(now);
+			}
+		}
+	}
+	for (Bot& bot : bots)
+	{
+		bot.Disconnect();
+	}
+}
+
+const Scenario& BotGroup::GetScenario() const
+{
+	return scenario;
+}
+
+const sockaddr* BotGroup::GetAddress() const
+{
+	return reinterpret_cast<const sockaddr*>(&address);
+}
+
+socklen_t BotGroup::GetAddressSize() const
+{
+	return addressSize;
+}
+
+Lobby& BotGroup::GetLobby()
+{
+	return lobby;
+}
+
+LoadStatistics& BotGroup::GetStatistics()
+{
+	return statistics;
+}
+
+std::minstd_rand& BotGroup::GetRandom()
+{
+	return random;
+}
+
+bool BotGroup::Watch(Bot& bot, bool registered, bool writable)
+{
+	epoll_event event = {};
+	event.events = uint32_t(EPOLLIN) | (writable ? uint32_t(EPOLLOUT) : 0u);
+	event.data.ptr = &bot;
+	return epoll_ctl(epoll, registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, bot.GetSocket(), &event) == 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Bot.h"
+#include "LatencyHistogram.h"
+#include <sys/socket.h>
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+struct LoadStatistics
+{
+	LatencyHistogram latencies[size_t(Action::count)];
+	uint64_t sent[size_t(Action::count)] = {};
+	uint64_t timeouts[size_t(Action::count)] = {};
+	uint64_t connectFailures = 0;
+	uint64_t disconnects = 0;
+	uint64_t errors = 0;
+	uint64_t messages = 0;
+	uint64_t bytes = 0;
+	std::string lastError;
+
+	void Merge(const LoadStatistics& other);
+};
+
+// the rooms a real client would offer to join, fed by the broadcasts one observer bot receives
+class Lobby
+{
+public:
+	void Reset(const Json& roomsList);
+	void Update(const Json& message);
+	bool HasOpenRoom() const;
+	int PickOpenRoom(std::minstd_rand& random) const;
+private:
+	struct RoomView
+	{
+		bool guest = false;
+		bool locked = false;
+	};
+	void Set(int roomId, RoomView view);
+	void Remove(int roomId);
+	void SetOpen(int roomId, bool open);
+private:
+	std::unordered_map<int, RoomView> rooms;
+	std::unordered_map<int, size_t> openPositions;
+	std::vector<int> open;
+};
+
+// drives a share of the bots from one epoll loop, one group per thread
+class BotGroup
+{
+public:
+	BotGroup(const Scenario& scenario, const sockaddr_storage& address, socklen_t addressSize, size_t first, size_t stride, uint32_t seed);
+	BotGroup(const BotGroup&) = delete;
+	BotGroup& operator=(const BotGroup&) = delete;
+	~BotGroup();
+	void Run(Clock::time_point start, Clock::time_point end);
+	const Scenario& GetScenario() const;
+	const sockaddr* GetAddress() const;
+	socklen_t GetAddressSize() const;
+	Lobby& GetLobby();
+	LoadStatistics& GetStatistics();
+	std::minstd_rand& GetRandom();
+	bool Watch(Bot& bot, bool registered, bool writable);
+private:
+	static constexpr const int MAX_EVENTS = 256;
+	static constexpr const std::chrono::milliseconds TICK = std::chrono::milliseconds(1);
+	const Scenario& scenario;
+	sockaddr_storage address;
+	socklen_t addressSize;
+	std::deque<Bot> bots;
+	size_t first;
+	size_t stride;
+	Lobby lobby;
+	LoadStatistics statistics;
+	std::minstd_rand random;
+	int epoll = -1;
+};
@@ -0,0 +1,74 @@
+#include "LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+void LatencyHistogram::Record(std::chrono::microseconds latency)
+{
+	const uint64_t value = uint64_t(std::max<long long>(0, latency.count()));
+	++counts[ToBucket(value)];
+	++count;
+	sum += value;
+	max = std::max(max, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+	for (int bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket)
+	{
+		counts[bucket] += other.counts[bucket];
+	}
+	count += other.count;
+	sum += other.sum;
+	max = std::max(max, other.max);
+}
+
+uint64_t LatencyHistogram::GetCount() const
+{
+	return count;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const
+{
+	const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(percentile / 100.0 * count)));
+	uint64_t seen = 0;
+	for (int bucket = 0; bucket < NUMBER_OF_BUCKETS; ++bucket)
+	{
+		seen += counts[bucket];
+		if (seen >= rank)
+		{
+			return std::min(ToUpperBound(bucket), max);
+		}
+	}
+	return max;
+}
+
+uint64_t LatencyHistogram::GetMax() const
+{
+	return max;
+}
+
+double LatencyHistogram::GetMean() const
+{
+	return count ? double(sum) / count : 0.0;
+}
+
+int LatencyHistogram::ToBucket(uint64_t value)
+{
+	if (value < SUB_BUCKETS)
+	{
+		return int(value);
+	}
+	const int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+	return shift * SUB_BUCKETS + int(value >> shift);
+}
+
+uint64_t LatencyHistogram::ToUpperBound(int bucket)
+{
+	if (bucket < 2 * SUB_BUCKETS)
+	{
+		return uint64_t(bucket);
+	}
+	const int shift = bucket / SUB_BUCKETS - 1;
+	const uint64_t top = SUB_BUCKETS + bucket % SUB_BUCKETS;
+	return ((top + 1) << shift) - 1;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// log-linear buckets, every power of two is split into SUB_BUCKETS so any recorded value
+// is reported within 1/SUB_BUCKETS of its true size
+class LatencyHistogram
+{
+public:
+	static constexpr const int SUB_BUCKET_BITS = 4;
+	static constexpr const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+	static constexpr const int NUMBER_OF_BUCKETS = 64 * SUB_BUCKETS;
+public:
+	void Record(std::chrono::microseconds latency);
+	void Merge(const LatencyHistogram& other);
+	uint64_t GetCount() const;
+	uint64_t GetPercentile(double percentile) const;
+	uint64_t GetMax() const;
+	double GetMean() const;
+private:
+	static int ToBucket(uint64_t value);
+	static uint64_t ToUpperBound(int bucket);
+private:
+	std::array<uint64_t, NUMBER_OF_BUCKETS> counts = {};
+	uint64_t count = 0;
+	uint64_t sum = 0;
+	uint64_t max = 0;
+};
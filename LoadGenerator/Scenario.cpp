@@ -0,0 +1,94 @@
+#include "Scenario.h"
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	constexpr const char* ACTION_NAMES[] = { "connect", "createRoom", "join", "lock", "quit", "changeRoom" };
+	static_assert(sizeof(ACTION_NAMES) / sizeof(*ACTION_NAMES) == size_t(Action::count), "missing action name");
+
+	// names have to pass the server's user name checks with the bot number appended
+	constexpr const size_t MIN_USER_NAME = 3;
+	constexpr const size_t MAX_USER_NAME = 10;
+}
+
+const char* toString(Action action)
+{
+	return ACTION_NAMES[size_t(action)];
+}
+
+bool toAction(const std::string& name, Action& action)
+{
+	for (size_t i = 0; i < size_t(Action::count); ++i)
+	{
+		if (name == ACTION_NAMES[i])
+		{
+			action = Action(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool Scenario::Load(const std::string& path, Scenario& scenario, std::string& error)
+{
+	std::ifstream in(path);
+	if (!in)
+	{
+		error = "could not open " + path;
+		return false;
+	}
+	const Json config = Json::parse(in, nullptr, false);
+	if (!config.is_object())
+	{
+		error = path + " is not a json object";
+		return false;
+	}
+	try
+	{
+		scenario.ip = config.value("IP", scenario.ip);
+		scenario.port = config.value("PORT", scenario.port);
+		scenario.namePrefix = config.value("NAME_PREFIX", scenario.namePrefix);
+		scenario.connections = config.value("CONNECTIONS", scenario.connections);
+		scenario.threads = std::max<size_t>(1, config.value("THREADS", scenario.threads));
+		scenario.connectRate = config.value("CONNECT_RATE", scenario.connectRate);
+		scenario.duration = std::chrono::seconds(config.value("DURATION", scenario.duration.count()));
+		scenario.responseTimeout = std::chrono::milliseconds(config.value("RESPONSE_TIMEOUT_MS", scenario.responseTimeout.count()));
+		scenario.encoding = toEncoding(config.value("ENCODING", std::string(toString(scenario.encoding))));
+		if (config.contains("THINK_MS"))
+		{
+			scenario.minThink = std::chrono::milliseconds(config["THINK_MS"].at(0).get<long long>());
+			scenario.maxThink = std::chrono::milliseconds(config["THINK_MS"].at(1).get<long long>());
+		}
+		if (config.contains("MIX"))
+		{
+			std::fill(std::begin(scenario.weights), std::end(scenario.weights), 0);
+			for (const auto& item : config["MIX"].items())
+			{
+				Action action;
+				if (!toAction(item.key(), action))
+				{
+					error = "unknown action " + item.key();
+					return false;
+				}
+				scenario.weights[size_t(action)] = item.value().get<unsigned int>();
+			}
+		}
+	}
+	catch (const Json::exception& exception)
+	{
+		error = path + ": " + exception.what();
+		return false;
+	}
+	if (scenario.namePrefix.size() + 1 < MIN_USER_NAME || scenario.namePrefix.size() + std::to_string(scenario.connections).size() > MAX_USER_NAME)
+	{
+		error = "NAME_PREFIX does not fit the user name limits for " + std::to_string(scenario.connections) + " connections";
+		return false;
+	}
+	if (scenario.minThink > scenario.maxThink || scenario.connectRate <= 0.0)
+	{
+		error = "THINK_MS has to be an ascending pair and CONNECT_RATE positive";
+		return false;
+	}
+	return true;
+}
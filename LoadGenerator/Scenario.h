@@ -0,0 +1,36 @@
+#pragma once
+#include "Protocol.h"
+#include <chrono>
+#include <string>
+
+enum class Action : uint8_t
+{
+	connect,
+	createRoom,
+	join,
+	lock,
+	quit,
+	changeRoom,
+	count
+};
+
+const char* toString(Action action);
+bool toAction(const std::string& name, Action& action);
+
+struct Scenario
+{
+	std::string ip = "127.0.0.1";
+	unsigned short port = 1000;
+	std::string namePrefix = "bot";
+	size_t connections = 100;
+	size_t threads = 1;
+	double connectRate = 100.0;
+	std::chrono::seconds duration = std::chrono::seconds(30);
+	std::chrono::milliseconds minThink = std::chrono::milliseconds(50);
+	std::chrono::milliseconds maxThink = std::chrono::milliseconds(250);
+	std::chrono::milliseconds responseTimeout = std::chrono::milliseconds(2000);
+	Encoding encoding = Encoding::binary;
+	unsigned int weights[size_t(Action::count)] = { 1, 10, 20, 10, 15, 20 };
+
+	static bool Load(const std::string& path, Scenario& scenario, std::string& error);
+};
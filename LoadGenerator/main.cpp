@@ -0,0 +1,110 @@
+#include "BotGroup.h"
+#include <netdb.h>
+#include <sys/resource.h>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static bool resolve(const Scenario& scenario, sockaddr_storage& address, socklen_t& addressSize)
+{
+	addrinfo hints = {};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* found = nullptr;
+	if (getaddrinfo(scenario.ip.c_str(), std::to_string(scenario.port).c_str(), &hints, &found) != 0 || !found)
+	{
+		return false;
+	}
+	std::memcpy(&address, found->ai_addr, found->ai_addrlen);
+	addressSize = socklen_t(found->ai_addrlen);
+	freeaddrinfo(found);
+	return true;
+}
+
+// every bot holds a descriptor, the default soft limit of 1024 would cap the swarm
+static void raiseDescriptorLimit(size_t connections)
+{
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+	{
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < connections + 64)
+	{
+		std::cerr << "descriptor limit " << limit.rlim_cur << " is too low for " << connections << " connections\n";
+	}
+}
+
+static void report(const Scenario& scenario, const LoadStatistics& statistics)
+{
+	std::printf("%-12s %10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "action", "sent", "answered", "timeouts",
+		"mean us", "p50 us", "p90 us", "p99 us", "p99.9 us", "max us");
+	uint64_t answered = 0;
+	for (size_t i = 0; i < size_t(Action::count); ++i)
+	{
+		const LatencyHistogram& latencies = statistics.latencies[i];
+		answered += latencies.GetCount();
+		std::printf("%-12s %10llu %10llu %10llu %10.0f %10llu %10llu %10llu %10llu %10llu\n", toString(Action(i)),
+			(unsigned long long)statistics.sent[i], (unsigned long long)latencies.GetCount(), (unsigned long long)statistics.timeouts[i],
+			latencies.GetMean(), (unsigned long long)latencies.GetPercentile(50.0), (unsigned long long)latencies.GetPercentile(90.0),
+			(unsigned long long)latencies.GetPercentile(99.0), (unsigned long long)latencies.GetPercentile(99.9), (unsigned long long)latencies.GetMax());
+	}
+	std::printf("%.1f answered requests/s, %llu messages, %.1f MB received\n", double(answered) / scenario.duration.count(),
+		(unsigned long long)statistics.messages, statistics.bytes / (1024.0 * 1024.0));
+	std::printf("%llu failed connects, %llu disconnects, %llu server errors%s%s\n", (unsigned long long)statistics.connectFailures,
+		(unsigned long long)statistics.disconnects, (unsigned long long)statistics.errors,
+		statistics.lastError.empty() ? "" : ", last: ", statistics.lastError.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: LoadGenerator <scenario.json>\n";
+		return 1;
+	}
+	Scenario scenario;
+	std::string error;
+	if (!Scenario::Load(argv[1], scenario, error))
+	{
+		std::cerr << error << '\n';
+		return 1;
+	}
+	sockaddr_storage address = {};
+	socklen_t addressSize = 0;
+	if (!resolve(scenario, address, addressSize))
+	{
+		std::cerr << "could not resolve " << scenario.ip << ':' << scenario.port << '\n';
+		return 1;
+	}
+	raiseDescriptorLimit(scenario.connections);
+
+	const size_t numberOfThreads = std::min(scenario.threads, std::max<size_t>(1, scenario.connections));
+	std::vector<std::unique_ptr<BotGroup>> groups;
+	for (size_t t = 0; t < numberOfThreads; ++t)
+	{
+		groups.push_back(std::make_unique<BotGroup>(scenario, address, addressSize, t, numberOfThreads, uint32_t(t + 1)));
+	}
+	const Clock::time_point start = Clock::now();
+	const Clock::time_point end = start + scenario.duration;
+	std::vector<std::thread> workers;
+	for (const std::unique_ptr<BotGroup>& group : groups)
+	{
+		workers.emplace_back(&BotGroup::Run, group.get(), start, end);
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	LoadStatistics statistics;
+	for (const std::unique_ptr<BotGroup>& group : groups)
+	{
+		statistics.Merge(group->GetStatistics());
+	}
+	report(scenario, statistics);
+	return 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Vyukov's bounded MPMC queue: per-slot sequence numbers order producers and consumers without locks
+template<typename T>
+class BoundedQueue
+{
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		T value;
+	};
+public:
+	BoundedQueue(size_t capacity)
+		: capacity(RoundUp(capacity)), mask(this->capacity - 1), slots(std::make_unique<Slot[]>(this->capacity))
+	{
+		for (size_t i = 0; i < this->capacity; ++i)
+		{
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+	bool TryPush(T&& value)
+	{
+		size_t position = enqueuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot& slot = slots[position & mask];
+			const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			const ptrdiff_t difference = ptrdiff_t(sequence) - ptrdiff_t(position);
+			if (difference == 0)
+			{
+				if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					slot.value = std::move(value);
+					slot.sequence.store(position + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	bool TryPop(T& value)
+	{
+		size_t position = dequeuePosition.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Slot& slot = slots[position & mask];
+			const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+			const ptrdiff_t difference = ptrdiff_t(sequence) - ptrdiff_t(position + 1);
+			if (difference == 0)
+			{
+				if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					value = std::move(slot.value);
+					slot.sequence.store(position + capacity, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = dequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+	}
+	size_t GetSize() const
+	{
+		const size_t dequeued = dequeuePosition.load(std::memory_order_relaxed);
+		const size_t enqueued = enqueuePosition.load(std::memory_order_relaxed);
+		return enqueued > dequeued ? enqueued - dequeued : 0;
+	}
+	size_t GetCapacity() const
+	{
+		return capacity;
+	}
+private:
+	static size_t RoundUp(size_t capacity)
+	{
+		size_t rounded = 2;
+		while (rounded < capacity)
+		{
+			rounded *= 2;
+		}
+		return rounded;
+	}
+private:
+	static constexpr const size_t CACHE_LINE_SIZE = 64;
+	const size_t capacity;
+	const size_t mask;
+	std::unique_ptr<Slot[]> slots;
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueuePosition = 0;
+	alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeuePosition = 0;
+};
@@ -0,0 +1,190 @@
+#include "Connection.h"
+#include "IOCore.h"
+#include "Logger.h"
+
+Connection::Connection(ServerSocket&& socket, IOCore& owner, size_t outboundCapacity, OverflowPolicy overflowPolicy)
+	: owner(owner), socket(std::move(socket)), outbound(outboundCapacity, overflowPolicy)
+{
+}
+
+Result Connection::Read()
+{
+	char buffer[4096];
+	while (true)
+	{
+		int bytesRecieved = 0;
+		Result result = socket.recieve(buffer, sizeof(buffer), bytesRecieved);
+		if (result == Result::wouldBlock)
+		{
+			break;
+		}
+		if (result != Result::success)
+		{
+			return result;
+		}
+		inbound.append(buffer, bytesRecieved);
+	}
+	return ExtractMessages();
+}
+
+Result Connection::Send(const Json& message)
+{
+	return Send(std::make_shared<const std::string>(encodeMessage(message, encoding)));
+}
+
+Result Connection::Send(MessageWriter& message)
+{
+	return Send(std::make_shared<const std::string>(message.Release()));
+}
+
+Result Connection::Send(SharedFrame frame, uint64_t coalesceKey, bool droppable)
+{
+	if (IsClosing())
+	{
+		return Result::genericError;
+	}
+	std::lock_guard<std::mutex> lock(outboundMutex);
+	return Enqueued(outbound.Push(std::move(frame), coalesceKey, droppable));
+}
+
+Result Connection::Resync(std::initializer_list<SharedFrame> snapshots)
+{
+	if (IsClosing())
+	{
+		return Result::genericError;
+	}
+	std::lock_guard<std::mutex> lock(outboundMutex);
+	return Enqueued(outbound.Resync(snapshots));
+}
+
+size_t Connection::GetDropped()
+{
+	std::lock_guard<std::mutex> lock(outboundMutex);
+	return outbound.GetDropped();
+}
+
+Encoding Connection::GetEncoding() const
+{
+	return encoding;
+}
+
+void Connection::SetEncoding(Encoding encoding)
+{
+	this->encoding = encoding;
+}
+
+void Connection::Close()
+{
+	if (!closing.exchange(true))
+	{
+		owner.Schedule(*this);
+	}
+}
+
+bool Connection::IsClosing() const
+{
+	return closing.load();
+}
+
+ServerSocket& Connection::GetSocket()
+{
+	return socket;
+}
+
+std::string Connection::toString() const
+{
+	return socket.toString();
+}
+
+Result Connection::ExtractMessages()
+{
+	size_t offset = 0;
+	std::vector<std::string> messages;
+	while (true)
+	{
+		const char* payload = nullptr;
+		uint32_t payloadSize = 0;
+		Result result = peekFrame(inbound.c_str() + offset, inbound.size() - offset, payload, payloadSize);
+		if (result == Result::wouldBlock)
+		{
+			break;
+		}
+		if (result != Result::success)
+		{
+			return result;
+		}
+		messages.emplace_back(payload, payloadSize);
+		offset += FRAME_HEADER_SIZE + payloadSize;
+	}
+	inbound.erase(0, offset);
+
+	if (!messages.empty())
+	{
+		std::lock_guard<std::mutex> lock(inboxMutex);
+		for (std::string& message : messages)
+		{
+			inbox.push_back(std::move(message));
+		}
+	}
+	return Result::success;
+}
+
+Result Connection::Enqueued(bool pushed)
+{
+	if (!pushed)
+	{
+		LOG << "outbound queue of " + toString() + " overflowed\n";
+		Close();
+		return Result::genericError;
+	}
+	// senders usually hold the lobby lock, the socket is written by the poll thread instead
+	if (!writePending && !flushScheduled)
+	{
+		flushScheduled = true;
+		owner.ScheduleFlush(*this);
+	}
+	return Result::success;
+}
+
+void Connection::OnWritable()
+{
+	std::lock_guard<std::mutex> lock(outboundMutex);
+	if (writePending)
+	{
+		Flush();
+	}
+}
+
+void Connection::OnFlush()
+{
+	std::lock_guard<std::mutex> lock(outboundMutex);
+	flushScheduled = false;
+	if (!writePending && !IsClosing())
+	{
+		Flush();
+	}
+}
+
+Result Connection::Flush()
+{
+	Result result = outbound.Flush(socket);
+	if (result == Result::wouldBlock)
+	{
+		if (!writePending)
+		{
+			writePending = true;
+			owner.poller.SetWritable(socket.getHandle(), this, true);
+		}
+		return Result::success;
+	}
+	if (writePending)
+	{
+		writePending = false;
+		owner.poller.SetWritable(socket.getHandle(), this, false);
+	}
+	if (result != Result::success)
+	{
+		Close();
+	}
+	return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "ServerSocket.h"
+#include "Protocol.h"
+#include "OutboundQueue.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct User;
+class IOCore;
+
+class Connection
+{
+	friend class IOCore;
+public:
+	Connection(ServerSocket&& socket, IOCore& owner, size_t outboundCapacity, OverflowPolicy overflowPolicy);
+	Connection(const Connection&) = delete;
+	Connection& operator=(const Connection&) = delete;
+	Result Read();
+	Result Send(const Json& message);
+	Result Send(MessageWriter& message);
+	Result Send(SharedFrame frame, uint64_t coalesceKey = 0, bool droppable = false);
+	Result Resync(std::initializer_list<SharedFrame> snapshots);
+	size_t GetDropped();
+	Encoding GetEncoding() const;
+	void SetEncoding(Encoding encoding);
+	void Close();
+	bool IsClosing() const;
+	ServerSocket& GetSocket();
+	std::string toString() const;
+public:
+	User* user = nullptr;
+private:
+	Result ExtractMessages();
+	Result Enqueued(bool pushed);
+	void OnWritable();
+	void OnFlush();
+	Result Flush();
+private:
+	IOCore& owner;
+	ServerSocket socket;
+	std::string inbound;
+	std::mutex inboxMutex;
+	std::vector<std::string> inbox;
+	Encoding encoding = Encoding::json;
+	std::mutex outboundMutex;
+	OutboundQueue outbound;
+	bool writePending = false;
+	bool flushScheduled = false;
+	bool scheduled = false;
+	bool retired = false;
+	std::atomic<bool> closing = false;
+};
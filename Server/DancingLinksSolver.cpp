@@ -0,0 +1,230 @@
+#include "DancingLinksSolver.h"
+#include <algorithm>
+
+DancingLinksSolver::DancingLinksSolver()
+{
+	for (int node = ROOT; node <= NUMBER_OF_COLUMNS; ++node)
+	{
+		left[node] = int16_t(node == ROOT ? NUMBER_OF_COLUMNS : node - 1);
+		right[node] = int16_t(node == NUMBER_OF_COLUMNS ? ROOT : node + 1);
+		up[node] = int16_t(node);
+		down[node] = int16_t(node);
+		columnOf[node] = int16_t(node);
+		sizes[node] = 0;
+	}
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		for (int digit = 1; digit <= SudokuBoard::SIZE; ++digit)
+		{
+			// cell, row-digit, column-digit and box-digit constraints, headers are 1-based
+			const int columns[NODES_PER_ROW] = {
+				1 + cell,
+				1 + SudokuBoard::NUMBER_OF_CELLS + SudokuBoard::RowOf(cell) * SudokuBoard::SIZE + digit - 1,
+				1 + 2 * SudokuBoard::NUMBER_OF_CELLS + SudokuBoard::ColumnOf(cell) * SudokuBoard::SIZE + digit - 1,
+				1 + 3 * SudokuBoard::NUMBER_OF_CELLS + SudokuBoard::BoxOf(cell) * SudokuBoard::SIZE + digit - 1
+			};
+			const int first = FirstNodeOf(cell, digit);
+			for (int i = 0; i < NODES_PER_ROW; ++i)
+			{
+				const int node = first + i;
+				const int column = columns[i];
+				left[node] = int16_t(first + (i + NODES_PER_ROW - 1) % NODES_PER_ROW);
+				right[node] = int16_t(first + (i + 1) % NODES_PER_ROW);
+				up[node] = up[column];
+				down[node] = int16_t(column);
+				down[up[column]] = int16_t(node);
+				up[column] = int16_t(node);
+				columnOf[node] = int16_t(column);
+				++sizes[column];
+			}
+		}
+	}
+}
+
+bool DancingLinksSolver::Solve(SudokuBoard& board)
+{
+	if (CountSolutions(board, 1) == 0)
+	{
+		return false;
+	}
+	const int numberOfEmpty = SudokuBoard::NUMBER_OF_CELLS - board.GetNumberOfFilled();
+	for (int i = 0; i < numberOfEmpty; ++i)
+	{
+		const int row = (firstSolution[i] - FIRST_ROW_NODE) / NODES_PER_ROW;
+		board.Place(row / SudokuBoard::SIZE, row % SudokuBoard::SIZE + 1);
+	}
+	return true;
+}
+
+size_t DancingLinksSolver::CountSolutions(const SudokuBoard& board, size_t limit)
+{
+	Load(board, limit);
+	Search();
+	Unload();
+	return solutions;
+}
+
+bool DancingLinksSolver::HasSolutionWithout(const SudokuBoard& board, int cell, int digit)
+{
+	if (board.Get(cell))
+	{
+		return false;
+	}
+	// the excluded row leaves the matrix first so covering the givens never touches it
+	const int excluded = FirstNodeOf(cell, digit);
+	UnlinkRow(excluded);
+	Load(board, 1);
+	Search();
+	Unload();
+	RelinkRow(excluded);
+	return solutions > 0;
+}
+
+size_t DancingLinksSolver::GetNumberOfGuesses() const
+{
+	return guesses;
+}
+
+void DancingLinksSolver::Load(const SudokuBoard& board, size_t limit)
+{
+	this->limit = limit ? limit : 1;
+	solutions = 0;
+	guesses = 0;
+	numberOfSelected = 0;
+	numberOfGivens = 0;
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		if (const int digit = board.Get(cell))
+		{
+			const int node = FirstNodeOf(cell, digit);
+			SelectRow(node);
+			givens[numberOfGivens++] = int16_t(node);
+		}
+	}
+}
+
+void DancingLinksSolver::Unload()
+{
+	while (numberOfGivens > 0)
+	{
+		DeselectRow(givens[--numberOfGivens]);
+	}
+}
+
+void DancingLinksSolver::Cover(int column)
+{
+	right[left[column]] = right[column];
+	left[right[column]] = left[column];
+	for (int row = down[column]; row != column; row = down[row])
+	{
+		for (int node = right[row]; node != row; node = right[node])
+		{
+			down[up[node]] = down[node];
+			up[down[node]] = up[node];
+			--sizes[columnOf[node]];
+		}
+	}
+}
+
+void DancingLinksSolver::Uncover(int column)
+{
+	for (int row = up[column]; row != column; row = up[row])
+	{
+		for (int node = left[row]; node != row; node = left[node])
+		{
+			++sizes[columnOf[node]];
+			down[up[node]] = int16_t(node);
+			up[down[node]] = int16_t(node);
+		}
+	}
+	right[left[column]] = int16_t(column);
+	left[right[column]] = int16_t(column);
+}
+
+void DancingLinksSolver::SelectRow(int node)
+{
+	Cover(columnOf[node]);
+	for (int other = right[node]; other != node; other = right[other])
+	{
+		Cover(columnOf[other]);
+	}
+}
+
+void DancingLinksSolver::DeselectRow(int node)
+{
+	for (int other = left[node]; other != node; other = left[other])
+	{
+		Uncover(columnOf[other]);
+	}
+	Uncover(columnOf[node]);
+}
+
+void DancingLinksSolver::UnlinkRow(int node)
+{
+	for (int i = 0; i < NODES_PER_ROW; ++i, node = right[node])
+	{
+		down[up[node]] = down[node];
+		up[down[node]] = up[node];
+		--sizes[columnOf[node]];
+	}
+}
+
+void DancingLinksSolver::RelinkRow(int node)
+{
+	for (int i = 0; i < NODES_PER_ROW; ++i, node = right[node])
+	{
+		++sizes[columnOf[node]];
+		down[up[node]] = int16_t(node);
+		up[down[node]] = int16_t(node);
+	}
+}
+
+bool DancingLinksSolver::Search()
+{
+	if (right[ROOT] == ROOT)
+	{
+		if (solutions++ == 0)
+		{
+			std::copy(selected, selected + numberOfSelected, firstSolution);
+		}
+		return solutions >= limit;
+	}
+	int best = right[ROOT];
+	for (int column = right[best]; column != ROOT && sizes[best] > 1; column = right[column])
+	{
+		if (sizes[column] < sizes[best])
+		{
+			best = column;
+		}
+	}
+	if (sizes[best] == 0)
+	{
+		return false;
+	}
+	// the column is covered once here and its rows select the remaining three columns each
+	const bool guessing = sizes[best] > 1;
+	Cover(best);
+	bool done = false;
+	for (int row = down[best]; row != best && !done; row = down[row])
+	{
+		guesses += guessing ? 1 : 0;
+		selected[numberOfSelected++] = int16_t(row);
+		for (int node = right[row]; node != row; node = right[node])
+		{
+			Cover(columnOf[node]);
+		}
+		done = Search();
+		for (int node = left[row]; node != row; node = left[node])
+		{
+			Uncover(columnOf[node]);
+		}
+		--numberOfSelected;
+	}
+	Uncover(best);
+	return done;
+}
+
+int DancingLinksSolver::FirstNodeOf(int cell, int digit)
+{
+	return FIRST_ROW_NODE + (cell * SudokuBoard::SIZE + digit - 1) * NODES_PER_ROW;
+}
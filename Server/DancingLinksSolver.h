@@ -0,0 +1,46 @@
+#pragma once
+#include "SolverBackend.h"
+
+// Knuth's Algorithm X over the 324-column exact-cover matrix. The matrix is linked once
+// on construction, givens are covered before a search and uncovered after it.
+class DancingLinksSolver final : public SolverBackend
+{
+public:
+	DancingLinksSolver();
+	bool Solve(SudokuBoard& board) override;
+	size_t CountSolutions(const SudokuBoard& board, size_t limit = 2) override;
+	bool HasSolutionWithout(const SudokuBoard& board, int cell, int digit) override;
+	size_t GetNumberOfGuesses() const override;
+private:
+	void Load(const SudokuBoard& board, size_t limit);
+	void Unload();
+	void Cover(int column);
+	void Uncover(int column);
+	void SelectRow(int node);
+	void DeselectRow(int node);
+	void UnlinkRow(int node);
+	void RelinkRow(int node);
+	bool Search();
+	static int FirstNodeOf(int cell, int digit);
+private:
+	static constexpr const int NUMBER_OF_COLUMNS = 4 * SudokuBoard::NUMBER_OF_CELLS;
+	static constexpr const int NUMBER_OF_ROWS = SudokuBoard::NUMBER_OF_CELLS * SudokuBoard::SIZE;
+	static constexpr const int NODES_PER_ROW = 4;
+	static constexpr const int ROOT = 0;
+	static constexpr const int FIRST_ROW_NODE = 1 + NUMBER_OF_COLUMNS;
+	static constexpr const int NUMBER_OF_NODES = FIRST_ROW_NODE + NUMBER_OF_ROWS * NODES_PER_ROW;
+	int16_t left[NUMBER_OF_NODES];
+	int16_t right[NUMBER_OF_NODES];
+	int16_t up[NUMBER_OF_NODES];
+	int16_t down[NUMBER_OF_NODES];
+	int16_t columnOf[NUMBER_OF_NODES];
+	int16_t sizes[1 + NUMBER_OF_COLUMNS];
+	int16_t givens[SudokuBoard::NUMBER_OF_CELLS];
+	int numberOfGivens = 0;
+	int16_t selected[SudokuBoard::NUMBER_OF_CELLS];
+	int numberOfSelected = 0;
+	int16_t firstSolution[SudokuBoard::NUMBER_OF_CELLS];
+	size_t limit = 1;
+	size_t solutions = 0;
+	size_t guesses = 0;
+};
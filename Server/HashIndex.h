@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class HashIndex
+{
+private:
+	struct Slot
+	{
+		Key key{};
+		Value value{};
+		uint32_t hash = 0;
+		bool occupied = false;
+	};
+public:
+	HashIndex(size_t capacity = MIN_CAPACITY)
+	{
+		Rehash(capacity);
+	}
+	Value* Find(const Key& key)
+	{
+		const uint32_t hash = HashOf(key);
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			Slot& slot = slots[i];
+			if (!slot.occupied)
+			{
+				return nullptr;
+			}
+			if (slot.hash == hash && slot.key == key)
+			{
+				return &slot.value;
+			}
+		}
+	}
+	const Value* Find(const Key& key) const
+	{
+		return const_cast<HashIndex*>(this)->Find(key);
+	}
+	bool Contains(const Key& key) const
+	{
+		return Find(key) != nullptr;
+	}
+	bool Insert(const Key& key, Value value)
+	{
+		if ((size + 1) * MAX_LOAD_DENOMINATOR > slots.size() * MAX_LOAD_NUMERATOR)
+		{
+			Rehash(slots.size() * 2);
+		}
+		const uint32_t hash = HashOf(key);
+		for (size_t i = hash & mask;; i = (i + 1) & mask)
+		{
+			Slot& slot = slots[i];
+			if (!slot.occupied)
+			{
+				slot.key = key;
+				slot.value = std::move(value);
+				slot.hash = hash;
+				slot.occupied = true;
+				++size;
+				return true;
+			}
+			if (slot.hash == hash && slot.key == key)
+			{
+				return false;
+			}
+		}
+	}
+	bool Erase(const Key& key)
+	{
+		const uint32_t hash = HashOf(key);
+		size_t i = hash & mask;
+		for (;; i = (i + 1) & mask)
+		{
+			if (!slots[i].occupied)
+			{
+				return false;
+			}
+			if (slots[i].hash == hash && slots[i].key == key)
+			{
+				break;
+			}
+		}
+		// backward shift keeps probe sequences intact without tombstones
+		for (size_t j = (i + 1) & mask; slots[j].occupied; j = (j + 1) & mask)
+		{
+			const size_t home = slots[j].hash & mask;
+			if (((j - home) & mask) >= ((j - i) & mask))
+			{
+				slots[i] = std::move(slots[j]);
+				i = j;
+			}
+		}
+		slots[i] = Slot{};
+		--size;
+		return true;
+	}
+	size_t GetSize() const
+	{
+		return size;
+	}
+private:
+	uint32_t HashOf(const Key& key) const
+	{
+		// fibonacci mixing so identity hashes of sequential ids spread over the table
+		return uint32_t((uint64_t(Hash{}(key)) * 0x9E3779B97F4A7C15ull) >> 32);
+	}
+	void Rehash(size_t capacity)
+	{
+		size_t newCapacity = MIN_CAPACITY;
+		while (newCapacity < capacity)
+		{
+			newCapacity *= 2;
+		}
+		std::vector<Slot> old(newCapacity);
+		old.swap(slots);
+		mask = newCapacity - 1;
+		for (Slot& slot : old)
+		{
+			if (slot.occupied)
+			{
+				size_t i = slot.hash & mask;
+				while (slots[i].occupied)
+				{
+					i = (i + 1) & mask;
+				}
+				slots[i] = std::move(slot);
+			}
+		}
+	}
+private:
+	static constexpr const size_t MIN_CAPACITY = 16;
+	static constexpr const size_t MAX_LOAD_NUMERATOR = 3;
+	static constexpr const size_t MAX_LOAD_DENOMINATOR = 4;
+	std::vector<Slot> slots;
+	size_t mask = 0;
+	size_t size = 0;
+};
@@ -0,0 +1,476 @@
+#include "HintEngine.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr const char* TECHNIQUE_NAMES[] = {
+		"naked single", "hidden single", "naked pair", "naked triple", "pointing", "box/line reduction",
+		"x-wing", "swordfish", "chain"
+	};
+	static_assert(sizeof(TECHNIQUE_NAMES) / sizeof(*TECHNIQUE_NAMES) == size_t(Technique::count), "missing technique name");
+
+	bool isPeer(int cell, int other)
+	{
+		return sudokuTables.rowOf[cell] == sudokuTables.rowOf[other] || sudokuTables.columnOf[cell] == sudokuTables.columnOf[other] ||
+			sudokuTables.boxOf[cell] == sudokuTables.boxOf[other];
+	}
+}
+
+const char* toString(Technique technique)
+{
+	return TECHNIQUE_NAMES[size_t(technique)];
+}
+
+void HintEngine::Load(const LiveBoard& board)
+{
+	for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+	{
+		cells[cell] = uint8_t(board.Get(cell));
+		candidates[cell] = board.GetCandidates(cell);
+	}
+}
+
+bool HintEngine::Next(Deduction& deduction, Clock::time_point deadline)
+{
+	UpdatePositions();
+	deduction = Deduction();
+	const bool found = FindNakedSingle(deduction) || FindHiddenSingle(deduction) ||
+		FindNakedSubset(2, deduction) || FindNakedSubset(3, deduction) ||
+		FindPointing(deduction) || FindBoxLine(deduction) ||
+		(Clock::now() < deadline && (FindFish(2, deduction) || FindFish(3, deduction) || FindChain(deduction, deadline)));
+	if (found)
+	{
+		Apply(deduction);
+	}
+	return found;
+}
+
+bool HintEngine::FindPlacement(const LiveBoard& board, Clock::time_point deadline, Deduction& hint)
+{
+	// eliminations are applied until a placement appears, the hardest step explains the hint
+	Load(board);
+	hint = Deduction();
+	Deduction step;
+	while (Clock::now() < deadline && Next(step, deadline))
+	{
+		if (hint.causes.empty() || step.technique > hint.technique)
+		{
+			hint.technique = step.technique;
+			hint.causes = step.causes;
+			hint.targets = step.targets;
+			hint.eliminated = step.eliminated;
+		}
+		if (step.cell >= 0)
+		{
+			hint.cell = step.cell;
+			hint.digit = step.digit;
+			return true;
+		}
+	}
+	return false;
+}
+
+void HintEngine::UpdatePositions()
+{
+	for (int unit = 0; unit < SudokuTables::NUMBER_OF_UNITS; ++unit)
+	{
+		std::fill(std::begin(positions[unit]), std::end(positions[unit]), uint16_t(0));
+		for (int index = 0; index < SIZE; ++index)
+		{
+			for (DigitMask digits = candidates[sudokuTables.units[unit][index]]; digits; digits &= digits - 1)
+			{
+				positions[unit][sudokuTables.digitOf[digits] - 1] |= uint16_t(1u << index);
+			}
+		}
+	}
+}
+
+bool HintEngine::FindNakedSingle(Deduction& deduction) const
+{
+	for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+	{
+		if (!cells[cell] && sudokuTables.bitCounts[candidates[cell]] == 1)
+		{
+			deduction.technique = Technique::nakedSingle;
+			deduction.cell = cell;
+			deduction.digit = sudokuTables.digitOf[candidates[cell]];
+			deduction.causes.push_back(cell);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HintEngine::FindHiddenSingle(Deduction& deduction) const
+{
+	for (int unit = 0; unit < SudokuTables::NUMBER_OF_UNITS; ++unit)
+	{
+		for (int digit = 1; digit <= SIZE; ++digit)
+		{
+			const uint16_t mask = positions[unit][digit - 1];
+			if (sudokuTables.bitCounts[mask] != 1)
+			{
+				continue;
+			}
+			deduction.technique = Technique::hiddenSingle;
+			deduction.cell = sudokuTables.units[unit][sudokuTables.digitOf[mask] - 1];
+			deduction.digit = digit;
+			deduction.causes.assign(std::begin(sudokuTables.units[unit]), std::end(sudokuTables.units[unit]));
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HintEngine::FindNakedSubset(int size, Deduction& deduction) const
+{
+	for (int unit = 0; unit < SudokuTables::NUMBER_OF_UNITS; ++unit)
+	{
+		int members[SIZE];
+		int numberOfMembers = 0;
+		for (int index = 0; index < SIZE; ++index)
+		{
+			const DigitMask mask = candidates[sudokuTables.units[unit][index]];
+			if (mask && sudokuTables.bitCounts[mask] <= size)
+			{
+				members[numberOfMembers++] = index;
+			}
+		}
+		for (int i = 0; i < numberOfMembers; ++i)
+		{
+			for (int j = i + 1; j < numberOfMembers; ++j)
+			{
+				// a pair stops at j, a triple takes a third member after it
+				for (int k = size == 2 ? j : j + 1; k < (size == 2 ? j + 1 : numberOfMembers); ++k)
+				{
+					const int subset[3] = { members[i], members[j], members[k] };
+					DigitMask digits = 0;
+					uint16_t excluded = 0;
+					for (int index : subset)
+					{
+						digits |= candidates[sudokuTables.units[unit][index]];
+						excluded |= uint16_t(1u << index);
+					}
+					if (sudokuTables.bitCounts[digits] != size || !CollectTargets(unit, digits, excluded, deduction))
+					{
+						continue;
+					}
+					deduction.technique = size == 2 ? Technique::nakedPair : Technique::nakedTriple;
+					deduction.eliminated = digits;
+					for (int index = 0; index < SIZE; ++index)
+					{
+						if (excluded & (1u << index))
+						{
+							deduction.causes.push_back(sudokuTables.units[unit][index]);
+						}
+					}
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool HintEngine::FindPointing(Deduction& deduction) const
+{
+	for (int box = 0; box < SIZE; ++box)
+	{
+		const int unit = 2 * SIZE + box;
+		for (int digit = 1; digit <= SIZE; ++digit)
+		{
+			const uint16_t mask = positions[unit][digit - 1];
+			if (sudokuTables.bitCounts[mask] < 2)
+			{
+				continue;
+			}
+			uint16_t rows = 0;
+			uint16_t columns = 0;
+			for (int index = 0; index < SIZE; ++index)
+			{
+				if (mask & (1u << index))
+				{
+					rows |= uint16_t(1u << sudokuTables.rowOf[sudokuTables.units[unit][index]]);
+					columns |= uint16_t(1u << sudokuTables.columnOf[sudokuTables.units[unit][index]]);
+				}
+			}
+			// the line's cells inside the box are the three positions belonging to the box's stack or band
+			int line = -1;
+			uint16_t inside = 0;
+			if (sudokuTables.bitCounts[rows] == 1)
+			{
+				line = sudokuTables.digitOf[rows] - 1;
+				inside = uint16_t(7u << (box % 3 * 3));
+			}
+			else if (sudokuTables.bitCounts[columns] == 1)
+			{
+				line = SIZE + sudokuTables.digitOf[columns] - 1;
+				inside = uint16_t(7u << (box / 3 * 3));
+			}
+			if (line < 0 || !CollectTargets(line, sudokuTables.digitMasks[digit], inside, deduction))
+			{
+				continue;
+			}
+			deduction.technique = Technique::pointing;
+			deduction.eliminated = sudokuTables.digitMasks[digit];
+			for (int index = 0; index < SIZE; ++index)
+			{
+				if (mask & (1u << index))
+				{
+					deduction.causes.push_back(sudokuTables.units[unit][index]);
+				}
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HintEngine::FindBoxLine(Deduction& deduction) const
+{
+	for (int line = 0; line < 2 * SIZE; ++line)
+	{
+		for (int digit = 1; digit <= SIZE; ++digit)
+		{
+			const uint16_t mask = positions[line][digit - 1];
+			if (sudokuTables.bitCounts[mask] < 2)
+			{
+				continue;
+			}
+			uint16_t boxes = 0;
+			for (int index = 0; index < SIZE; ++index)
+			{
+				if (mask & (1u << index))
+				{
+					boxes |= uint16_t(1u << sudokuTables.boxOf[sudokuTables.units[line][index]]);
+				}
+			}
+			if (sudokuTables.bitCounts[boxes] != 1)
+			{
+				continue;
+			}
+			const int box = sudokuTables.digitOf[boxes] - 1;
+			uint16_t inside = 0;
+			for (int index = 0; index < SIZE; ++index)
+			{
+				const int cell = sudokuTables.units[2 * SIZE + box][index];
+				if (sudokuTables.unitsOf[cell][line / SIZE] == line)
+				{
+					inside |= uint16_t(1u << index);
+				}
+			}
+			if (!CollectTargets(2 * SIZE + box, sudokuTables.digitMasks[digit], inside, deduction))
+			{
+				continue;
+			}
+			deduction.technique = Technique::boxLine;
+			deduction.eliminated = sudokuTables.digitMasks[digit];
+			for (int index = 0; index < SIZE; ++index)
+			{
+				if (mask & (1u << index))
+				{
+					deduction.causes.push_back(sudokuTables.units[line][index]);
+				}
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+bool HintEngine::FindFish(int size, Deduction& deduction) const
+{
+	// rows as base lines and columns as cover lines, then the other way round
+	for (int base = 0; base < 2 * SIZE; base += SIZE)
+	{
+		const int cover = SIZE - base;
+		for (int digit = 1; digit <= SIZE; ++digit)
+		{
+			int lines[SIZE];
+			int numberOfLines = 0;
+			for (int line = 0; line < SIZE; ++line)
+			{
+				const int count = sudokuTables.bitCounts[positions[base + line][digit - 1]];
+				if (count >= 2 && count <= size)
+				{
+					lines[numberOfLines++] = line;
+				}
+			}
+			for (int i = 0; i < numberOfLines; ++i)
+			{
+				for (int j = i + 1; j < numberOfLines; ++j)
+				{
+					for (int k = size == 2 ? j : j + 1; k < (size == 2 ? j + 1 : numberOfLines); ++k)
+					{
+						const int fish[3] = { lines[i], lines[j], lines[k] };
+						uint16_t covered = 0;
+						uint16_t baseLines = 0;
+						for (int line : fish)
+						{
+							covered |= positions[base + line][digit - 1];
+							baseLines |= uint16_t(1u << line);
+						}
+						if (sudokuTables.bitCounts[covered] != size)
+						{
+							continue;
+						}
+						// the i-th cell of a cover line lies on the i-th base line
+						bool found = false;
+						for (int line = 0; line < SIZE; ++line)
+						{
+							if (covered & (1u << line))
+							{
+								found = CollectTargets(cover + line, sudokuTables.digitMasks[digit], baseLines, deduction) || found;
+							}
+						}
+						if (!found)
+						{
+							continue;
+						}
+						deduction.technique = size == 2 ? Technique::xWing : Technique::swordfish;
+						deduction.eliminated = sudokuTables.digitMasks[digit];
+						for (int line = 0; line < SIZE; ++line)
+						{
+							for (int index = 0; index < SIZE; ++index)
+							{
+								if ((baseLines & (1u << line)) && (positions[base + line][digit - 1] & (1u << index)))
+								{
+									deduction.causes.push_back(sudokuTables.units[base + line][index]);
+								}
+							}
+						}
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool HintEngine::FindChain(Deduction& deduction, Clock::time_point deadline) const
+{
+	// simple colouring: conjugate pairs form chains whose two colours hold the digit alternately
+	for (int digit = 1; digit <= SIZE && Clock::now() < deadline; ++digit)
+	{
+		const DigitMask mask = sudokuTables.digitMasks[digit];
+		int8_t colors[SudokuTables::NUMBER_OF_CELLS];
+		std::fill(std::begin(colors), std::end(colors), int8_t(-1));
+		for (int start = 0; start < SudokuTables::NUMBER_OF_CELLS; ++start)
+		{
+			if (colors[start] >= 0 || !(candidates[start] & mask))
+			{
+				continue;
+			}
+			int chain[SudokuTables::NUMBER_OF_CELLS];
+			int length = 0;
+			chain[length++] = start;
+			colors[start] = 0;
+			for (int i = 0; i < length; ++i)
+			{
+				const int cell = chain[i];
+				for (int unit : sudokuTables.unitsOf[cell])
+				{
+					const uint16_t places = positions[unit][digit - 1];
+					if (sudokuTables.bitCounts[places] != 2)
+					{
+						continue;
+					}
+					for (int index = 0; index < SIZE; ++index)
+					{
+						const int other = sudokuTables.units[unit][index];
+						if ((places & (1u << index)) && other != cell && colors[other] < 0)
+						{
+							colors[other] = int8_t(colors[cell] ^ 1);
+							chain[length++] = other;
+						}
+					}
+				}
+			}
+			if (length < 3)
+			{
+				continue;
+			}
+			// two cells of one colour seeing each other make that whole colour false
+			int falseColor = -1;
+			for (int i = 0; i < length && falseColor < 0; ++i)
+			{
+				for (int j = i + 1; j < length && falseColor < 0; ++j)
+				{
+					if (colors[chain[i]] == colors[chain[j]] && isPeer(chain[i], chain[j]))
+					{
+						falseColor = colors[chain[i]];
+					}
+				}
+			}
+			for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+			{
+				if (!(candidates[cell] & mask))
+				{
+					continue;
+				}
+				bool eliminated = false;
+				if (falseColor >= 0)
+				{
+					eliminated = std::find(chain, chain + length, cell) != chain + length && colors[cell] == falseColor;
+				}
+				else if (std::find(chain, chain + length, cell) == chain + length)
+				{
+					// a cell seeing both colours loses the digit whichever colour is true
+					bool sees[2] = { false, false };
+					for (int i = 0; i < length; ++i)
+					{
+						sees[colors[chain[i]]] = sees[colors[chain[i]]] || isPeer(cell, chain[i]);
+					}
+					eliminated = sees[0] && sees[1];
+				}
+				if (eliminated)
+				{
+					deduction.targets.push_back(cell);
+				}
+			}
+			if (!deduction.targets.empty())
+			{
+				deduction.technique = Technique::chain;
+				deduction.eliminated = mask;
+				deduction.causes.assign(chain, chain + length);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+bool HintEngine::CollectTargets(int unit, DigitMask digits, uint16_t excluded, Deduction& deduction) const
+{
+	bool found = false;
+	for (int index = 0; index < SIZE; ++index)
+	{
+		const int cell = sudokuTables.units[unit][index];
+		if (!(excluded & (1u << index)) && (candidates[cell] & digits))
+		{
+			deduction.targets.push_back(cell);
+			found = true;
+		}
+	}
+	return found;
+}
+
+void HintEngine::Apply(const Deduction& deduction)
+{
+	if (deduction.cell < 0)
+	{
+		for (int target : deduction.targets)
+		{
+			candidates[target] &= ~deduction.eliminated;
+		}
+		return;
+	}
+	const DigitMask mask = sudokuTables.digitMasks[deduction.digit];
+	cells[deduction.cell] = uint8_t(deduction.digit);
+	candidates[deduction.cell] = 0;
+	for (int peer : sudokuTables.peers[deduction.cell])
+	{
+		candidates[peer] &= ~mask;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "LiveBoard.h"
+#include <chrono>
+#include <vector>
+
+enum class Technique : uint8_t
+{
+	nakedSingle,
+	hiddenSingle,
+	nakedPair,
+	nakedTriple,
+	pointing,
+	boxLine,
+	xWing,
+	swordfish,
+	chain,
+	count
+};
+
+const char* toString(Technique technique);
+
+struct Deduction
+{
+	Technique technique = Technique::nakedSingle;
+	// a placement when cell is set, otherwise the eliminated digits leave every target
+	int cell = -1;
+	int digit = 0;
+	DigitMask eliminated = 0;
+	std::vector<int> causes;
+	std::vector<int> targets;
+};
+
+// Technique-ordered logical solver, every step is the simplest deduction the position allows.
+class HintEngine
+{
+public:
+	using Clock = std::chrono::steady_clock;
+public:
+	void Load(const LiveBoard& board);
+	bool Next(Deduction& deduction, Clock::time_point deadline);
+	bool FindPlacement(const LiveBoard& board, Clock::time_point deadline, Deduction& hint);
+private:
+	void UpdatePositions();
+	bool FindNakedSingle(Deduction& deduction) const;
+	bool FindHiddenSingle(Deduction& deduction) const;
+	bool FindNakedSubset(int size, Deduction& deduction) const;
+	bool FindPointing(Deduction& deduction) const;
+	bool FindBoxLine(Deduction& deduction) const;
+	bool FindFish(int size, Deduction& deduction) const;
+	bool FindChain(Deduction& deduction, Clock::time_point deadline) const;
+	bool CollectTargets(int unit, DigitMask digits, uint16_t excluded, Deduction& deduction) const;
+	void Apply(const Deduction& deduction);
+private:
+	static constexpr const int SIZE = SudokuTables::SIZE;
+	uint8_t cells[SudokuTables::NUMBER_OF_CELLS];
+	DigitMask candidates[SudokuTables::NUMBER_OF_CELLS];
+	// bit i is set when the i-th cell of the unit may still hold the digit
+	uint16_t positions[SudokuTables::NUMBER_OF_UNITS][SIZE];
+};
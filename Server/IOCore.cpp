@@ -0,0 +1,345 @@
+#include "IOCore.h"
+#include "Logger.h"
+#include <algorithm>
+
+// the error only concerns the connection being accepted, the rest of the backlog can still be taken
+static bool isAbortedAccept(int error)
+{
+#ifdef __linux__
+	return error == EINTR || error == ECONNABORTED || error == EPROTO || error == EPERM;
+#else
+	return error == WSAEINTR || error == WSAECONNRESET;
+#endif
+}
+
+IOCore::IOCore(size_t numberOfWorkers, size_t outboundCapacity, OverflowPolicy overflowPolicy, MessageHandler onMessage, DisconnectHandler onDisconnect)
+	: numberOfWorkers(numberOfWorkers ? numberOfWorkers : 1), outboundCapacity(outboundCapacity), overflowPolicy(overflowPolicy), onMessage(std::move(onMessage)), onDisconnect(std::move(onDisconnect))
+{
+}
+
+void IOCore::Start()
+{
+	alive.store(true);
+	pollThread = std::make_unique<std::thread>(&IOCore::Poll, this);
+	for (size_t i = 0; i < numberOfWorkers; ++i)
+	{
+		workers.emplace_back(&IOCore::Work, this);
+	}
+}
+
+void IOCore::Listen(ServerSocket&& listener)
+{
+	this->listener = std::move(listener);
+	poller.Add(this->listener.getHandle(), &this->listener);
+}
+
+void IOCore::Drain(std::chrono::milliseconds timeout)
+{
+	// stops taking connections and requests, lets the queued replies go out and then closes everyone
+	if (!alive.load())
+	{
+		return;
+	}
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+	draining.store(true);
+	poller.Wake();
+	while (HasPendingWork() && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(DRAIN_STEP);
+	}
+	{
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		for (const auto& connection : connections)
+		{
+			connection.second->Close();
+		}
+	}
+	while (std::chrono::steady_clock::now() < deadline)
+	{
+		{
+			std::lock_guard<std::mutex> lock(connectionsMutex);
+			if (connections.empty())
+			{
+				break;
+			}
+		}
+		std::this_thread::sleep_for(DRAIN_STEP);
+	}
+	Stop();
+}
+
+void IOCore::Stop()
+{
+	if (!alive.exchange(false))
+	{
+		return;
+	}
+	poller.Wake();
+	queueCondition.notify_all();
+	if (pollThread)
+	{
+		pollThread->join();
+		pollThread.reset();
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+}
+
+void IOCore::AddConnection(ServerSocket&& socket)
+{
+	if (socket.setIOMode(IOMode::fionbio, 1ul) != Result::success)
+	{
+		LOG << "could not switch " + socket.toString() + " to non-blocking mode\n";
+		return;
+	}
+	auto connection = std::make_unique<Connection>(std::move(socket), *this, outboundCapacity, overflowPolicy);
+	Connection* key = connection.get();
+	{
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		connections.emplace(key, std::move(connection));
+	}
+	poller.Add(key->GetSocket().getHandle(), key);
+}
+
+IOCore::~IOCore()
+{
+	Stop();
+}
+
+void IOCore::Poll()
+{
+	PollEvent events[MAX_EVENTS];
+	while (alive.load())
+	{
+		int count = poller.Wait(events, MAX_EVENTS, POLL_TIMEOUT);
+		if (draining.load() && listener.getHandle() != INVALID_SOCKET)
+		{
+			StopListening();
+		}
+		if (acceptBackoff && std::chrono::steady_clock::now() >= acceptRetry)
+		{
+			Accept();
+		}
+		for (int i = 0; i < count; ++i)
+		{
+			if (events[i].key == &listener)
+			{
+				Accept();
+				continue;
+			}
+			Connection& connection = *static_cast<Connection*>(events[i].key);
+			if (!connection.IsClosing() && (events[i].readable || events[i].closed) && connection.Read() != Result::success)
+			{
+				connection.Close();
+			}
+			if (!connection.IsClosing() && events[i].writable)
+			{
+				connection.OnWritable();
+			}
+			Schedule(connection);
+		}
+		FlushScheduled();
+		ReleaseRetired();
+	}
+}
+
+void IOCore::Accept()
+{
+	// the listener is edge triggered on linux, so accept until the backlog is empty
+	while (!draining.load())
+	{
+		ServerSocket socket;
+		Result result = listener.accept(socket);
+		if (result == Result::wouldBlock)
+		{
+			acceptBackoff = false;
+			return;
+		}
+		if (result != Result::success)
+		{
+			const int error = lastSocketError();
+			if (isAbortedAccept(error))
+			{
+				continue;
+			}
+			// out of descriptors or buffers, no new edge comes for the connections already queued
+			if (!acceptBackoff)
+			{
+				LOG << "could not accept a client on " + listener.toString() + " (error " + std::to_string(error) + "), retrying\n";
+			}
+			acceptBackoff = true;
+			acceptRetry = std::chrono::steady_clock::now() + ACCEPT_BACKOFF;
+			return;
+		}
+		acceptBackoff = false;
+		LOG << "Added client on " + socket.toString() + '\n';
+		AddConnection(std::move(socket));
+	}
+}
+
+void IOCore::StopListening()
+{
+	poller.Remove(listener.getHandle());
+	listener.close();
+}
+
+bool IOCore::HasPendingWork()
+{
+	std::lock_guard<std::mutex> lock(connectionsMutex);
+	for (const auto& entry : connections)
+	{
+		Connection& connection = *entry.second;
+		{
+			std::lock_guard<std::mutex> inboxLock(connection.inboxMutex);
+			if (connection.scheduled || !connection.inbox.empty())
+			{
+				return true;
+			}
+		}
+		std::lock_guard<std::mutex> outboundLock(connection.outboundMutex);
+		if (!connection.IsClosing() && !connection.outbound.IsEmpty())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void IOCore::Work()
+{
+	while (true)
+	{
+		Connection* connection = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [this]() { return !readyConnections.empty() || !alive.load(); });
+			if (!alive.load())
+			{
+				return;
+			}
+			connection = readyConnections.front();
+			readyConnections.pop_front();
+		}
+		Process(*connection);
+	}
+}
+
+void IOCore::Schedule(Connection& connection)
+{
+	{
+		std::lock_guard<std::mutex> lock(connection.inboxMutex);
+		if (connection.scheduled || connection.retired || (connection.inbox.empty() && !connection.IsClosing()))
+		{
+			return;
+		}
+		connection.scheduled = true;
+	}
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		readyConnections.push_back(&connection);
+	}
+	queueCondition.notify_one();
+}
+
+void IOCore::ScheduleFlush(Connection& connection)
+{
+	bool wake = false;
+	{
+		std::lock_guard<std::mutex> lock(flushMutex);
+		wake = flushes.empty();
+		flushes.push_back(&connection);
+	}
+	if (wake)
+	{
+		poller.Wake();
+	}
+}
+
+void IOCore::FlushScheduled()
+{
+	std::vector<Connection*> pending;
+	{
+		std::lock_guard<std::mutex> lock(flushMutex);
+		pending.swap(flushes);
+	}
+	for (Connection* connection : pending)
+	{
+		connection->OnFlush();
+	}
+}
+
+void IOCore::Process(Connection& connection)
+{
+	std::vector<std::string> messages;
+	Request request;
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(connection.inboxMutex);
+			if (connection.IsClosing())
+			{
+				connection.retired = true;
+				break;
+			}
+			if (connection.inbox.empty())
+			{
+				connection.scheduled = false;
+				return;
+			}
+			messages.swap(connection.inbox);
+		}
+		for (const std::string& payload : messages)
+		{
+			if (connection.IsClosing() || draining.load())
+			{
+				break;
+			}
+			if (decodeRequest(payload.c_str(), payload.size(), connection.GetEncoding(), request) != Result::success)
+			{
+				LOG << "dropping " + connection.toString() + " - malformed message\n";
+				connection.Close();
+				break;
+			}
+			try
+			{
+				onMessage(connection, request);
+			}
+			catch (const std::exception& e)
+			{
+				LOG << "dropping " + connection.toString() + " - " + e.what() + '\n';
+				connection.Close();
+			}
+		}
+		messages.clear();
+	}
+	onDisconnect(connection);
+	{
+		std::lock_guard<std::mutex> lock(connectionsMutex);
+		retired.push_back(&connection);
+	}
+	poller.Wake();
+}
+
+void IOCore::ReleaseRetired()
+{
+	std::lock_guard<std::mutex> lock(connectionsMutex);
+	if (!retired.empty())
+	{
+		// a flush scheduled after this round's flushes must not outlive its connection
+		std::lock_guard<std::mutex> flushLock(flushMutex);
+		for (Connection* connection : retired)
+		{
+			flushes.erase(std::remove(flushes.begin(), flushes.end(), connection), flushes.end());
+		}
+	}
+	for (Connection* connection : retired)
+	{
+		LOG << "removed client on " + connection->toString() + '\n';
+		poller.Remove(connection->GetSocket().getHandle());
+		connections.erase(connection);
+	}
+	retired.clear();
+}
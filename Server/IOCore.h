@@ -0,0 +1,69 @@
+#pragma once
+#include "Connection.h"
+#include "Poller.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class IOCore
+{
+	friend class Connection;
+public:
+	using MessageHandler = std::function<void(Connection& connection, const Request& request)>;
+	using DisconnectHandler = std::function<void(Connection& connection)>;
+public:
+	IOCore(size_t numberOfWorkers, size_t outboundCapacity, OverflowPolicy overflowPolicy, MessageHandler onMessage, DisconnectHandler onDisconnect);
+	IOCore(const IOCore&) = delete;
+	IOCore& operator=(const IOCore&) = delete;
+	void Start();
+	void Listen(ServerSocket&& listener);
+	void Drain(std::chrono::milliseconds timeout);
+	void Stop();
+	void AddConnection(ServerSocket&& socket);
+	~IOCore();
+private:
+	void Poll();
+	void Accept();
+	void StopListening();
+	bool HasPendingWork();
+	void Work();
+	void Schedule(Connection& connection);
+	void ScheduleFlush(Connection& connection);
+	void FlushScheduled();
+	void Process(Connection& connection);
+	void ReleaseRetired();
+private:
+	static constexpr const int MAX_EVENTS = 64;
+	static constexpr const int POLL_TIMEOUT = 100;
+	static constexpr const std::chrono::milliseconds DRAIN_STEP = std::chrono::milliseconds(10);
+	static constexpr const std::chrono::milliseconds ACCEPT_BACKOFF = std::chrono::milliseconds(100);
+	size_t numberOfWorkers;
+	size_t outboundCapacity;
+	OverflowPolicy overflowPolicy;
+	MessageHandler onMessage;
+	DisconnectHandler onDisconnect;
+	Poller poller;
+	ServerSocket listener;
+	// accept failed with the backlog still queued, the poll thread retries after a backoff
+	bool acceptBackoff = false;
+	std::chrono::steady_clock::time_point acceptRetry;
+	std::atomic<bool> alive = false;
+	std::atomic<bool> draining = false;
+	std::unique_ptr<std::thread> pollThread;
+	std::vector<std::thread> workers;
+	std::mutex connectionsMutex;
+	std::unordered_map<Connection*, std::unique_ptr<Connection>> connections;
+	std::vector<Connection*> retired;
+	std::mutex flushMutex;
+	std::vector<Connection*> flushes;
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::deque<Connection*> readyConnections;
+};
@@ -1,8 +1,15 @@
 #pragma once
 #include "IPVersion.h"
+#include <cstdint>
 #include <string>
 #include <vector>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#else
 #include <WS2tcpip.h>
+#endif
 #include <iostream>
 
 
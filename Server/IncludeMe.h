@@ -1,5 +1,7 @@
 #pragma once
+#ifdef _MSC_VER
 #pragma comment(lib, "ws2_32.lib")
+#endif
 #include "NetworkEnvironment.h"
 #include "NetworkException.h"
 #include "Client.h"
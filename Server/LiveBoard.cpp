@@ -0,0 +1,148 @@
+#include "LiveBoard.h"
+
+LiveBoard::LiveBoard()
+	: cells{}, givens{}, counts{}, occupied{}, conflicts{}
+{
+}
+
+bool LiveBoard::Load(const std::string& puzzle)
+{
+	*this = LiveBoard();
+	if (puzzle.empty())
+	{
+		return true;
+	}
+	if (puzzle.size() != NUMBER_OF_CELLS)
+	{
+		return false;
+	}
+	for (int cell = 0; cell < NUMBER_OF_CELLS; ++cell)
+	{
+		const char c = puzzle[cell];
+		if (c >= '1' && c <= '9')
+		{
+			Set(cell, c - '0');
+			givens[cell] = 1;
+		}
+	}
+	return true;
+}
+
+bool LiveBoard::Place(int cell, int digit)
+{
+	if (cell < 0 || cell >= NUMBER_OF_CELLS || digit < 1 || digit > SIZE || givens[cell] || cells[cell] == digit)
+	{
+		return false;
+	}
+	history.push_back(Move{ uint8_t(cell), cells[cell], uint8_t(digit) });
+	Set(cell, digit);
+	return true;
+}
+
+bool LiveBoard::Erase(int cell)
+{
+	if (cell < 0 || cell >= NUMBER_OF_CELLS || givens[cell] || !cells[cell])
+	{
+		return false;
+	}
+	history.push_back(Move{ uint8_t(cell), cells[cell], 0 });
+	Set(cell, 0);
+	return true;
+}
+
+bool LiveBoard::Undo()
+{
+	if (history.empty())
+	{
+		return false;
+	}
+	const Move move = history.back();
+	history.pop_back();
+	Set(move.cell, move.previous);
+	return true;
+}
+
+DigitMask LiveBoard::GetCandidates(int cell) const
+{
+	if (cells[cell])
+	{
+		return 0;
+	}
+	const uint8_t* units = sudokuTables.unitsOf[cell];
+	return ALL_DIGITS & ~(occupied[units[0]] | occupied[units[1]] | occupied[units[2]]);
+}
+
+bool LiveBoard::HasConflict(int cell) const
+{
+	if (!cells[cell])
+	{
+		return false;
+	}
+	const uint8_t* units = sudokuTables.unitsOf[cell];
+	return ((conflicts[units[0]] | conflicts[units[1]] | conflicts[units[2]]) & sudokuTables.digitMasks[cells[cell]]) != 0;
+}
+
+std::string LiveBoard::ToString() const
+{
+	std::string text(NUMBER_OF_CELLS, '.');
+	for (int cell = 0; cell < NUMBER_OF_CELLS; ++cell)
+	{
+		if (cells[cell])
+		{
+			text[cell] = char('0' + cells[cell]);
+		}
+	}
+	return text;
+}
+
+void LiveBoard::Set(int cell, int digit)
+{
+	const auto& units = sudokuTables.unitsOf[cell];
+	if (cells[cell])
+	{
+		for (int unit : units)
+		{
+			Remove(unit, cells[cell]);
+		}
+		++remaining;
+	}
+	cells[cell] = uint8_t(digit);
+	if (digit)
+	{
+		for (int unit : units)
+		{
+			Add(unit, digit);
+		}
+		--remaining;
+	}
+}
+
+void LiveBoard::Add(int unit, int digit)
+{
+	const DigitMask mask = sudokuTables.digitMasks[digit];
+	switch (++counts[unit][digit - 1])
+	{
+	case 1:
+		occupied[unit] |= mask;
+		break;
+	case 2:
+		conflicts[unit] |= mask;
+		++numberOfConflicts;
+		break;
+	}
+}
+
+void LiveBoard::Remove(int unit, int digit)
+{
+	const DigitMask mask = sudokuTables.digitMasks[digit];
+	switch (counts[unit][digit - 1]--)
+	{
+	case 1:
+		occupied[unit] &= ~mask;
+		break;
+	case 2:
+		conflicts[unit] &= ~mask;
+		--numberOfConflicts;
+		break;
+	}
+}
@@ -0,0 +1,43 @@
+#include "LobbyLog.h"
+
+LobbyLog::LobbyLog(size_t capacity)
+	: capacity(capacity)
+{
+}
+
+void LobbyLog::SetCapacity(size_t capacity)
+{
+	this->capacity = capacity;
+	while (changes.size() > capacity)
+	{
+		changes.pop_front();
+	}
+}
+
+uint64_t LobbyLog::GetVersion() const
+{
+	return version;
+}
+
+void LobbyLog::Append(Frames frames, int roomId)
+{
+	++version;
+	if (capacity == 0)
+	{
+		return;
+	}
+	if (changes.size() == capacity)
+	{
+		changes.pop_front();
+	}
+	changes.push_back({ std::move(frames), roomId });
+}
+
+long long LobbyLog::CountSince(uint64_t version) const
+{
+	if (version > this->version || this->version - version > changes.size())
+	{
+		return -1;
+	}
+	return (long long)(this->version - version);
+}
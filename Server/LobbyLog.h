@@ -0,0 +1,40 @@
+#pragma once
+#include "OutboundQueue.h"
+#include "Protocol.h"
+#include <array>
+#include <cstdint>
+#include <deque>
+
+// the last lobby changes already encoded for both encodings, a client that reconnects with
+// a version the log still reaches back to is sent the changes it missed instead of the lists
+class LobbyLog
+{
+public:
+	using Frames = std::array<SharedFrame, size_t(Encoding::binary) + 1>;
+public:
+	LobbyLog(size_t capacity = 1024);
+	void SetCapacity(size_t capacity);
+	uint64_t GetVersion() const;
+	// roomId names the room a change belongs to, 0 for changes of the users list
+	void Append(Frames frames, int roomId = 0);
+	// number of changes after version, or -1 when the log no longer holds all of them
+	long long CountSince(uint64_t version) const;
+	template<typename Send>
+	void ReplaySince(uint64_t version, Encoding encoding, Send&& send) const
+	{
+		for (size_t i = changes.size() - size_t(this->version - version); i < changes.size(); ++i)
+		{
+			send(changes[i].frames[size_t(encoding)], changes[i].roomId);
+		}
+	}
+private:
+	struct Change
+	{
+		Frames frames;
+		int roomId;
+	};
+private:
+	size_t capacity;
+	uint64_t version = 0;
+	std::deque<Change> changes;
+};
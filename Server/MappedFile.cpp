@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	fileHandle = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fileHandle == -1)
+	{
+		return false;
+	}
+	struct stat status = {};
+	if (fstat(fileHandle, &status) != 0 || status.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+	void* view = mmap(nullptr, size_t(status.st_size), PROT_READ, MAP_SHARED, fileHandle, 0);
+	if (view == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+	data = static_cast<const uint8_t*>(view);
+	size = size_t(status.st_size);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (data)
+	{
+		munmap(const_cast<uint8_t*>(data), size);
+		data = nullptr;
+		size = 0;
+	}
+	if (fileHandle != -1)
+	{
+		close(fileHandle);
+		fileHandle = -1;
+	}
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle == NULL)
+	{
+		Close();
+		return false;
+	}
+	data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	if (!data)
+	{
+		Close();
+		return false;
+	}
+	size = size_t(fileSize.QuadPart);
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (data)
+	{
+		UnmapViewOfFile(data);
+		data = nullptr;
+		size = 0;
+	}
+	if (mappingHandle != NULL)
+	{
+		CloseHandle(mappingHandle);
+		mappingHandle = NULL;
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(fileHandle);
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+}
+
+#endif
+
+bool MappedFile::IsOpen() const
+{
+	return data != nullptr;
+}
+
+const uint8_t* MappedFile::GetData() const
+{
+	return data;
+}
+
+size_t MappedFile::GetSize() const
+{
+	return size;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
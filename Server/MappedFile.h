@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#ifndef __linux__
+#include <Windows.h>
+#endif
+
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	bool Open(const std::string& path);
+	void Close();
+	bool IsOpen() const;
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+	~MappedFile();
+private:
+#ifdef __linux__
+	int fileHandle = -1;
+#else
+	HANDLE fileHandle = INVALID_HANDLE_VALUE;
+	HANDLE mappingHandle = NULL;
+#endif
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+};
@@ -0,0 +1,36 @@
+#include "MessageFrame.h"
+
+void writeFrameHeader(char* destination, uint32_t payloadSize)
+{
+	destination[0] = static_cast<char>((payloadSize >> 24) & 0xFF);
+	destination[1] = static_cast<char>((payloadSize >> 16) & 0xFF);
+	destination[2] = static_cast<char>((payloadSize >> 8) & 0xFF);
+	destination[3] = static_cast<char>(payloadSize & 0xFF);
+}
+
+void appendFrameHeader(std::string& destination, uint32_t payloadSize)
+{
+	char header[FRAME_HEADER_SIZE];
+	writeFrameHeader(header, payloadSize);
+	destination.append(header, FRAME_HEADER_SIZE);
+}
+
+Result peekFrame(const char* data, size_t size, const char*& payload, uint32_t& payloadSize)
+{
+	if (size < FRAME_HEADER_SIZE)
+	{
+		return Result::wouldBlock;
+	}
+	const unsigned char* header = reinterpret_cast<const unsigned char*>(data);
+	payloadSize = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | uint32_t(header[3]);
+	if (payloadSize > MAX_FRAME_SIZE)
+	{
+		return Result::genericError;
+	}
+	if (size - FRAME_HEADER_SIZE < payloadSize)
+	{
+		return Result::wouldBlock;
+	}
+	payload = data + FRAME_HEADER_SIZE;
+	return Result::success;
+}
@@ -1,6 +1,26 @@
 #include "NetworkEnvironment.h"
 #include "NetworkException.h"
 #include <iostream>
+#ifdef __linux__
+#include <signal.h>
+#endif
+
+#ifdef __linux__
+
+void NetworkEnvironment::initialize()
+{
+    // a peer that hangs up mid write must surface as an error code, not kill the process
+    if (signal(SIGPIPE, SIG_IGN) == SIG_ERR)
+    {
+        throw NETWORK_EXCEPTION(errno);
+    }
+}
+
+void NetworkEnvironment::shutDown()
+{
+}
+
+#else
 
 void NetworkEnvironment::initialize()
 {
@@ -27,3 +47,4 @@ void NetworkEnvironment::shutDown()
     }
 }
 
+#endif
@@ -1,14 +1,18 @@
 #include "NetworkException.h"
-#include <Windows.h>
 #include <sstream>
+#ifdef __linux__
+#include <cstring>
+#else
+#include <Windows.h>
 #include <winbase.h>
+#endif
 
 NetworkException::NetworkException(int line, const char* file, int errorCode)
 	: line(line), file(file), errorCode(errorCode)
 {
 }
 
-const char* NetworkException::what() const
+const char* NetworkException::what() const noexcept
 {
 	std::ostringstream oss;
 	oss << getType() << std::endl
@@ -54,6 +58,9 @@ std::string NetworkException::getErrorString() const
 
 std::string NetworkException::translateErrorCode(int errorCode)
 {
+#ifdef __linux__
+	return std::strerror(errorCode);
+#else
 	char* msgBuf;
 	DWORD msgLength = FormatMessage(
 		FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
@@ -70,4 +77,5 @@ std::string NetworkException::translateErrorCode(int errorCode)
 	std::string errorString = msgBuf;
 	LocalFree(msgBuf);
 	return errorString;
-}
\ No newline at end of file
+#endif
+}
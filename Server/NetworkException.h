@@ -6,7 +6,7 @@ class NetworkException : public std::exception
 {
 public:
 	NetworkException(int line, const char* file, int errorCode);
-	const char* what() const override;
+	const char* what() const noexcept override;
 	virtual const char* getType() const;
 	int getLine() const;
 	std::string getFile() const;
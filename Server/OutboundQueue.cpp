@@ -0,0 +1,201 @@
+#include "OutboundQueue.h"
+#include <algorithm>
+
+OverflowPolicy toOverflowPolicy(const std::string& policy)
+{
+	if (policy == "dropOldest")
+	{
+		return OverflowPolicy::dropOldest;
+	}
+	if (policy == "coalesce")
+	{
+		return OverflowPolicy::coalesce;
+	}
+	return OverflowPolicy::disconnect;
+}
+
+OutboundQueue::OutboundQueue(size_t capacity, OverflowPolicy policy)
+	: capacity(capacity ? capacity : 1), policy(policy)
+{
+}
+
+bool OutboundQueue::Push(SharedFrame frame, uint64_t coalesceKey, bool droppable)
+{
+	if (!entries)
+	{
+		entries = std::make_unique<Entry[]>(capacity);
+	}
+	if (size == capacity)
+	{
+		bool freed = false;
+		if (policy == OverflowPolicy::coalesce && coalesceKey != 0)
+		{
+			freed = Coalesce(coalesceKey);
+		}
+		if (!freed && policy != OverflowPolicy::disconnect)
+		{
+			freed = DropOldest();
+		}
+		if (!freed)
+		{
+			return false;
+		}
+	}
+	Entry& entry = At(size++);
+	entry.frame = std::move(frame);
+	entry.coalesceKey = coalesceKey;
+	entry.droppable = droppable;
+	entry.snapshot = false;
+	return true;
+}
+
+bool OutboundQueue::Resync(std::initializer_list<SharedFrame> snapshots)
+{
+	if (!entries)
+	{
+		entries = std::make_unique<Entry[]>(capacity);
+	}
+	for (size_t i = sentBytes > 0 ? 1 : 0; i < size;)
+	{
+		if (At(i).droppable || At(i).snapshot)
+		{
+			Erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+	if (capacity - size < snapshots.size())
+	{
+		return false;
+	}
+	for (const SharedFrame& frame : snapshots)
+	{
+		Entry& entry = At(size++);
+		entry.frame = frame;
+		entry.coalesceKey = 0;
+		entry.droppable = false;
+		entry.snapshot = true;
+	}
+	return true;
+}
+
+Result OutboundQueue::Flush(Socket& socket)
+{
+	// queued frames go out in batches, every header and shared payload as its own buffer of
+	// one vectored send, so a broadcast costs one syscall instead of one per header and payload
+	char headers[MAX_BATCH][FRAME_HEADER_SIZE];
+	SocketBuffer buffers[2 * MAX_BATCH];
+	while (size > 0)
+	{
+		const size_t batch = std::min(size, MAX_BATCH);
+		int numberOfBuffers = 0;
+		size_t skip = sentBytes;
+		size_t batchBytes = 0;
+		for (size_t i = 0; i < batch; ++i)
+		{
+			const std::string& payload = *At(i).frame;
+			writeFrameHeader(headers[i], (uint32_t)payload.size());
+			// only the first frame of the queue can be partially sent
+			if (skip < FRAME_HEADER_SIZE)
+			{
+				buffers[numberOfBuffers++] = makeSocketBuffer(headers[i] + skip, FRAME_HEADER_SIZE - skip);
+				skip = 0;
+			}
+			else
+			{
+				skip -= FRAME_HEADER_SIZE;
+			}
+			if (skip < payload.size())
+			{
+				buffers[numberOfBuffers++] = makeSocketBuffer(payload.c_str() + skip, payload.size() - skip);
+			}
+			skip = 0;
+			batchBytes += FRAME_HEADER_SIZE + payload.size();
+		}
+		batchBytes -= sentBytes;
+		int bytesSent = 0;
+		Result result = socket.sendv(buffers, numberOfBuffers, bytesSent);
+		if (result != Result::success)
+		{
+			return result;
+		}
+		sentBytes += size_t(bytesSent);
+		while (size > 0)
+		{
+			Entry& entry = At(0);
+			const size_t frameSize = FRAME_HEADER_SIZE + entry.frame->size();
+			if (sentBytes < frameSize)
+			{
+				break;
+			}
+			sentBytes -= frameSize;
+			entry.frame.reset();
+			head = (head + 1) % capacity;
+			--size;
+		}
+		if (size_t(bytesSent) < batchBytes)
+		{
+			// the send buffer is full, another attempt would only fail
+			return Result::wouldBlock;
+		}
+	}
+	return Result::success;
+}
+
+bool OutboundQueue::IsEmpty() const
+{
+	return size == 0;
+}
+
+size_t OutboundQueue::GetSize() const
+{
+	return size;
+}
+
+size_t OutboundQueue::GetDropped() const
+{
+	return dropped;
+}
+
+OutboundQueue::Entry& OutboundQueue::At(size_t index)
+{
+	return entries[(head + index) % capacity];
+}
+
+bool OutboundQueue::Coalesce(uint64_t coalesceKey)
+{
+	for (size_t i = sentBytes > 0 ? 1 : 0; i < size; ++i)
+	{
+		if (At(i).coalesceKey == coalesceKey)
+		{
+			Erase(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool OutboundQueue::DropOldest()
+{
+	for (size_t i = sentBytes > 0 ? 1 : 0; i < size; ++i)
+	{
+		if (At(i).droppable)
+		{
+			Erase(i);
+			++dropped;
+			return true;
+		}
+	}
+	return false;
+}
+
+void OutboundQueue::Erase(size_t index)
+{
+	for (size_t i = index; i + 1 < size; ++i)
+	{
+		At(i) = std::move(At(i + 1));
+	}
+	At(--size) = Entry{};
+}
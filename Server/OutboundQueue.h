@@ -0,0 +1,52 @@
+#pragma once
+#include "Socket.h"
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+
+using SharedFrame = std::shared_ptr<const std::string>;
+
+enum class OverflowPolicy
+{
+	disconnect,
+	dropOldest,
+	coalesce
+};
+
+OverflowPolicy toOverflowPolicy(const std::string& policy);
+
+class OutboundQueue
+{
+public:
+	struct Entry
+	{
+		SharedFrame frame;
+		uint64_t coalesceKey = 0;
+		bool droppable = false;
+		bool snapshot = false;
+	};
+public:
+	OutboundQueue(size_t capacity, OverflowPolicy policy);
+	bool Push(SharedFrame frame, uint64_t coalesceKey, bool droppable);
+	// the snapshots describe the whole lobby, they replace every queued change and older snapshot
+	bool Resync(std::initializer_list<SharedFrame> snapshots);
+	Result Flush(Socket& socket);
+	bool IsEmpty() const;
+	size_t GetSize() const;
+	size_t GetDropped() const;
+private:
+	Entry& At(size_t index);
+	bool Coalesce(uint64_t coalesceKey);
+	bool DropOldest();
+	void Erase(size_t index);
+private:
+	static constexpr const size_t MAX_BATCH = 32;
+	size_t capacity;
+	OverflowPolicy policy;
+	std::unique_ptr<Entry[]> entries;
+	size_t head = 0;
+	size_t size = 0;
+	size_t sentBytes = 0;
+	size_t dropped = 0;
+};
@@ -1,20 +1,23 @@
 #pragma once
-#include "ServerSocket.h"
+#include "Connection.h"
+#include "LiveBoard.h"
 #include <string>
 
 struct Player
 {
 	Player() = default;
-	Player(const std::string& name, ServerSocket* socket)
-		: name(name), socket(socket)
+	Player(const std::string& name, Connection* connection)
+		: name(name), connection(connection)
 	{}
 	operator bool() const
 	{
 		return !name.empty();
 	}
 	std::string name;
-	unsigned long points;
-	unsigned long lifes;
-	ServerSocket* socket = nullptr;
+	unsigned long points = 0;
+	unsigned long lifes = 0;
+	bool ready = false;
+	LiveBoard board;
+	Connection* connection = nullptr;
 };
 
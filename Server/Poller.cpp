@@ -0,0 +1,208 @@
+#include "Poller.h"
+#include "NetworkException.h"
+#include <algorithm>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+
+Poller::Poller()
+{
+	epollHandle = epoll_create1(EPOLL_CLOEXEC);
+	if (epollHandle == -1)
+	{
+		throw NETWORK_EXCEPTION(errno);
+	}
+	wakeHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (wakeHandle == -1)
+	{
+		throw NETWORK_EXCEPTION(errno);
+	}
+	epoll_event event = {};
+	event.events = EPOLLIN | EPOLLET;
+	event.data.ptr = nullptr;
+	if (epoll_ctl(epollHandle, EPOLL_CTL_ADD, wakeHandle, &event) != 0)
+	{
+		throw NETWORK_EXCEPTION(errno);
+	}
+}
+
+void Poller::Add(SocketHandle handle, void* key)
+{
+	epoll_event event = {};
+	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	event.data.ptr = key;
+	if (epoll_ctl(epollHandle, EPOLL_CTL_ADD, handle, &event) != 0)
+	{
+		throw NETWORK_EXCEPTION(errno);
+	}
+}
+
+void Poller::SetWritable(SocketHandle, void*, bool)
+{
+	// sockets stay registered for EPOLLOUT, edge triggering only reports a transition to writable
+}
+
+void Poller::Remove(SocketHandle handle)
+{
+	epoll_ctl(epollHandle, EPOLL_CTL_DEL, handle, nullptr);
+}
+
+int Poller::Wait(PollEvent* events, int maxEvents, int timeout)
+{
+	epoll_event ready[64];
+	int count = epoll_wait(epollHandle, ready, std::min(maxEvents, 64), timeout);
+	if (count < 0)
+	{
+		return 0;
+	}
+	int eventsCount = 0;
+	for (int i = 0; i < count; ++i)
+	{
+		if (ready[i].data.ptr == nullptr)
+		{
+			eventfd_t value;
+			eventfd_read(wakeHandle, &value);
+			continue;
+		}
+		PollEvent& event = events[eventsCount++];
+		event.key = ready[i].data.ptr;
+		event.readable = (ready[i].events & EPOLLIN) != 0;
+		event.writable = (ready[i].events & EPOLLOUT) != 0;
+		event.closed = (ready[i].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0;
+	}
+	return eventsCount;
+}
+
+void Poller::Wake()
+{
+	eventfd_write(wakeHandle, 1);
+}
+
+Poller::~Poller()
+{
+	close(wakeHandle);
+	close(epollHandle);
+}
+
+#else
+
+Poller::Poller()
+{
+	wakeHandle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (wakeHandle == INVALID_SOCKET)
+	{
+		throw NETWORK_EXCEPTION(lastSocketError());
+	}
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	SocketLength addressLength = sizeof(address);
+	u_long nonBlocking = 1;
+	if (bind(wakeHandle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR
+		|| getsockname(wakeHandle, reinterpret_cast<sockaddr*>(&address), &addressLength) == SOCKET_ERROR
+		|| connect(wakeHandle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR
+		|| ioctlsocket(wakeHandle, FIONBIO, &nonBlocking) == SOCKET_ERROR)
+	{
+		const int error = lastSocketError();
+		closeSocket(wakeHandle);
+		throw NETWORK_EXCEPTION(error);
+	}
+}
+
+void Poller::Add(SocketHandle handle, void* key)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	WSAPOLLFD pollHandle = {};
+	pollHandle.fd = handle;
+	pollHandle.events = POLLRDNORM;
+	handles.push_back(pollHandle);
+	keys.push_back(key);
+}
+
+void Poller::SetWritable(SocketHandle handle, void* key, bool writable)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (WSAPOLLFD& pollHandle : handles)
+	{
+		if (pollHandle.fd == handle)
+		{
+			pollHandle.events = writable ? (POLLRDNORM | POLLWRNORM) : POLLRDNORM;
+			return;
+		}
+	}
+}
+
+void Poller::Remove(SocketHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < handles.size(); ++i)
+	{
+		if (handles[i].fd == handle)
+		{
+			handles.erase(handles.begin() + i);
+			keys.erase(keys.begin() + i);
+			return;
+		}
+	}
+}
+
+int Poller::Wait(PollEvent* events, int maxEvents, int timeout)
+{
+	std::vector<WSAPOLLFD> polled;
+	std::vector<void*> polledKeys;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		polled = handles;
+		polledKeys = keys;
+	}
+	WSAPOLLFD wakePollHandle = {};
+	wakePollHandle.fd = wakeHandle;
+	wakePollHandle.events = POLLRDNORM;
+	polled.push_back(wakePollHandle);
+	polledKeys.push_back(nullptr);
+	int count = WSAPoll(polled.data(), (ULONG)polled.size(), timeout);
+	if (count <= 0)
+	{
+		return 0;
+	}
+	int eventsCount = 0;
+	for (size_t i = 0; i < polled.size() && eventsCount < maxEvents; ++i)
+	{
+		if (polled[i].revents == 0)
+		{
+			continue;
+		}
+		if (polledKeys[i] == nullptr)
+		{
+			char buffer[64];
+			while (recv(wakeHandle, buffer, sizeof(buffer), 0) > 0)
+			{
+			}
+			continue;
+		}
+		PollEvent& event = events[eventsCount++];
+		event.key = polledKeys[i];
+		event.readable = (polled[i].revents & POLLRDNORM) != 0;
+		event.writable = (polled[i].revents & POLLWRNORM) != 0;
+		event.closed = (polled[i].revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+	}
+	return eventsCount;
+}
+
+void Poller::Wake()
+{
+	const char signal = 0;
+	send(wakeHandle, &signal, 1, 0);
+}
+
+Poller::~Poller()
+{
+	closeSocket(wakeHandle);
+}
+
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include "SocketHandle.h"
+#include <mutex>
+#include <vector>
+
+struct PollEvent
+{
+	void* key = nullptr;
+	bool readable = false;
+	bool writable = false;
+	bool closed = false;
+};
+
+class Poller
+{
+public:
+	Poller();
+	Poller(const Poller&) = delete;
+	Poller& operator=(const Poller&) = delete;
+	void Add(SocketHandle handle, void* key);
+	void SetWritable(SocketHandle handle, void* key, bool writable);
+	void Remove(SocketHandle handle);
+	int Wait(PollEvent* events, int maxEvents, int timeout);
+	void Wake();
+	~Poller();
+private:
+#ifdef __linux__
+	int epollHandle = -1;
+	int wakeHandle = -1;
+#else
+	// a loopback datagram socket connected to itself, sending to it ends a wait
+	SocketHandle wakeHandle = INVALID_SOCKET;
+	std::mutex mutex;
+	std::vector<WSAPOLLFD> handles;
+	std::vector<void*> keys;
+#endif
+};
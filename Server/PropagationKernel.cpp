@@ -0,0 +1,123 @@
+#include "PropagationKernel.h"
+#include "PropagationLanes.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace
+{
+	constexpr const char* KERNEL_NAMES[] = { "scalar", "sse4.1", "avx2" };
+	static_assert(sizeof(KERNEL_NAMES) / sizeof(*KERNEL_NAMES) == size_t(KernelLevel::count), "missing kernel name");
+	constexpr const int WIDTHS[] = { 1, 8, 16 };
+
+	struct ScalarLanes
+	{
+		using Vector = uint16_t;
+		static constexpr const int WIDTH = 1;
+		static Vector Load(const uint16_t* data) { return *data; }
+		static void Store(uint16_t* data, Vector value) { *data = value; }
+		static Vector Zero() { return 0; }
+		static Vector Set(uint16_t value) { return value; }
+		static Vector And(Vector a, Vector b) { return Vector(a & b); }
+		static Vector Or(Vector a, Vector b) { return Vector(a | b); }
+		static Vector Xor(Vector a, Vector b) { return Vector(a ^ b); }
+		static Vector AndNot(Vector a, Vector b) { return Vector(~a & b); }
+		static Vector Sub(Vector a, Vector b) { return Vector(a - b); }
+		static Vector IsZero(Vector a) { return a ? 0 : 0xFFFF; }
+		static Vector Select(Vector mask, Vector a, Vector b) { return Vector((mask & a) | (~mask & b)); }
+		static bool Any(Vector a) { return a != 0; }
+	};
+
+	void propagateScalar(uint16_t* solved, uint16_t* candidates, uint16_t* contradiction)
+	{
+		propagateLanes<ScalarLanes>(solved, candidates, contradiction);
+	}
+
+	using LanesFunction = void(*)(uint16_t*, uint16_t*, uint16_t*);
+	constexpr LanesFunction FUNCTIONS[] = { propagateScalar, propagateSse41, propagateAvx2 };
+}
+
+const char* toString(KernelLevel level)
+{
+	return KERNEL_NAMES[size_t(level)];
+}
+
+bool Propagation::operator==(const Propagation& other) const
+{
+	return filled == other.filled && contradiction == other.contradiction &&
+		std::equal(std::begin(cells), std::end(cells), other.cells) &&
+		std::equal(std::begin(candidates), std::end(candidates), other.candidates);
+}
+
+PropagationKernel::PropagationKernel()
+	: level(Detect())
+{
+}
+
+PropagationKernel::PropagationKernel(KernelLevel level)
+	: level(std::min(level, Detect()))
+{
+}
+
+KernelLevel PropagationKernel::GetLevel() const
+{
+	return level;
+}
+
+void PropagationKernel::Propagate(const SudokuBoard* boards, size_t count, Propagation* results) const
+{
+	const int width = WIDTHS[size_t(level)];
+	alignas(32) uint16_t solved[SudokuBoard::NUMBER_OF_CELLS * MAX_WIDTH];
+	alignas(32) uint16_t candidates[SudokuBoard::NUMBER_OF_CELLS * MAX_WIDTH];
+	alignas(32) uint16_t contradiction[MAX_WIDTH];
+	for (size_t first = 0; first < count; first += width)
+	{
+		const int numberOfBoards = int(std::min<size_t>(width, count - first));
+		for (int lane = 0; lane < width; ++lane)
+		{
+			// a short last batch repeats its final board in the unused lanes
+			const SudokuBoard& board = boards[first + std::min(lane, numberOfBoards - 1)];
+			for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+			{
+				const int digit = board.Get(cell);
+				solved[cell * width + lane] = digit ? SudokuBoard::ToMask(digit) : 0;
+				candidates[cell * width + lane] = digit ? SudokuBoard::ToMask(digit) : SudokuBoard::ALL_DIGITS;
+			}
+		}
+		FUNCTIONS[size_t(level)](solved, candidates, contradiction);
+		for (int lane = 0; lane < numberOfBoards; ++lane)
+		{
+			Propagation& result = results[first + lane];
+			result.filled = 0;
+			result.contradiction = contradiction[lane] != 0;
+			for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+			{
+				const DigitMask mask = solved[cell * width + lane];
+				result.cells[cell] = uint8_t(mask ? SudokuBoard::ToDigit(mask) : 0);
+				result.candidates[cell] = mask ? 0 : candidates[cell * width + lane];
+				result.filled += mask ? 1 : 0;
+			}
+		}
+	}
+}
+
+KernelLevel PropagationKernel::Detect()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	// AVX2 also needs the OS to save the upper register halves
+	const bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+	__cpuidex(info, 7, 0);
+	const bool avx2 = avx && (info[1] & (1 << 5));
+#else
+	__builtin_cpu_init();
+	const bool sse41 = __builtin_cpu_supports("sse4.1");
+	const bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+	return avx2 ? KernelLevel::avx2 : sse41 ? KernelLevel::sse41 : KernelLevel::scalar;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include "SudokuBoard.h"
+#include <cstddef>
+
+enum class KernelLevel : uint8_t
+{
+	scalar,
+	sse41,
+	avx2,
+	count
+};
+
+const char* toString(KernelLevel level);
+
+struct Propagation
+{
+	uint8_t cells[SudokuBoard::NUMBER_OF_CELLS];
+	DigitMask candidates[SudokuBoard::NUMBER_OF_CELLS];
+	int filled;
+	bool contradiction;
+	bool operator==(const Propagation& other) const;
+};
+
+// Fills naked and hidden singles into whole batches of boards. The vector levels run several
+// boards side by side and are chosen at runtime, falling back to scalar code on older CPUs.
+class PropagationKernel
+{
+public:
+	PropagationKernel();
+	PropagationKernel(KernelLevel level);
+	KernelLevel GetLevel() const;
+	void Propagate(const SudokuBoard* boards, size_t count, Propagation* results) const;
+	static KernelLevel Detect();
+private:
+	static constexpr const int MAX_WIDTH = 16;
+	KernelLevel level;
+};
@@ -0,0 +1,29 @@
+// built with AVX2 enabled, only called after PropagationKernel::Detect found it
+#include "PropagationLanes.h"
+#include <immintrin.h>
+
+namespace
+{
+	struct Avx2Lanes
+	{
+		using Vector = __m256i;
+		static constexpr const int WIDTH = 16;
+		static Vector Load(const uint16_t* data) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(data)); }
+		static void Store(uint16_t* data, Vector value) { _mm256_store_si256(reinterpret_cast<__m256i*>(data), value); }
+		static Vector Zero() { return _mm256_setzero_si256(); }
+		static Vector Set(uint16_t value) { return _mm256_set1_epi16(short(value)); }
+		static Vector And(Vector a, Vector b) { return _mm256_and_si256(a, b); }
+		static Vector Or(Vector a, Vector b) { return _mm256_or_si256(a, b); }
+		static Vector Xor(Vector a, Vector b) { return _mm256_xor_si256(a, b); }
+		static Vector AndNot(Vector a, Vector b) { return _mm256_andnot_si256(a, b); }
+		static Vector Sub(Vector a, Vector b) { return _mm256_sub_epi16(a, b); }
+		static Vector IsZero(Vector a) { return _mm256_cmpeq_epi16(a, _mm256_setzero_si256()); }
+		static Vector Select(Vector mask, Vector a, Vector b) { return _mm256_blendv_epi8(b, a, mask); }
+		static bool Any(Vector a) { return !_mm256_testz_si256(a, a); }
+	};
+}
+
+void propagateAvx2(uint16_t* solved, uint16_t* candidates, uint16_t* contradiction)
+{
+	propagateLanes<Avx2Lanes>(solved, candidates, contradiction);
+}
@@ -0,0 +1,29 @@
+// built with SSE4.1 enabled, only called after PropagationKernel::Detect found it
+#include "PropagationLanes.h"
+#include <smmintrin.h>
+
+namespace
+{
+	struct Sse41Lanes
+	{
+		using Vector = __m128i;
+		static constexpr const int WIDTH = 8;
+		static Vector Load(const uint16_t* data) { return _mm_load_si128(reinterpret_cast<const __m128i*>(data)); }
+		static void Store(uint16_t* data, Vector value) { _mm_store_si128(reinterpret_cast<__m128i*>(data), value); }
+		static Vector Zero() { return _mm_setzero_si128(); }
+		static Vector Set(uint16_t value) { return _mm_set1_epi16(short(value)); }
+		static Vector And(Vector a, Vector b) { return _mm_and_si128(a, b); }
+		static Vector Or(Vector a, Vector b) { return _mm_or_si128(a, b); }
+		static Vector Xor(Vector a, Vector b) { return _mm_xor_si128(a, b); }
+		static Vector AndNot(Vector a, Vector b) { return _mm_andnot_si128(a, b); }
+		static Vector Sub(Vector a, Vector b) { return _mm_sub_epi16(a, b); }
+		static Vector IsZero(Vector a) { return _mm_cmpeq_epi16(a, _mm_setzero_si128()); }
+		static Vector Select(Vector mask, Vector a, Vector b) { return _mm_blendv_epi8(b, a, mask); }
+		static bool Any(Vector a) { return !_mm_testz_si128(a, a); }
+	};
+}
+
+void propagateSse41(uint16_t* solved, uint16_t* candidates, uint16_t* contradiction)
+{
+	propagateLanes<Sse41Lanes>(solved, candidates, contradiction);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "SudokuTables.h"
+#include <cstdint>
+
+// Singles propagation over Lanes::WIDTH boards at once, one 16-bit lane per board. The data is
+// laid out cell-major, data[cell * WIDTH + lane]. Every instruction set runs exactly these steps,
+// which is what keeps the vector kernels bit-exact with the scalar one.
+template<typename Lanes>
+void propagateLanes(uint16_t* solvedData, uint16_t* candidatesData, uint16_t* contradictionData)
+{
+	using Vector = typename Lanes::Vector;
+	constexpr int WIDTH = Lanes::WIDTH;
+	Vector solved[SudokuTables::NUMBER_OF_CELLS];
+	Vector candidates[SudokuTables::NUMBER_OF_CELLS];
+	for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+	{
+		solved[cell] = Lanes::Load(solvedData + cell * WIDTH);
+		candidates[cell] = Lanes::Load(candidatesData + cell * WIDTH);
+	}
+	const Vector allDigits = Lanes::Set(SudokuTables::ALL_DIGITS);
+	const Vector one = Lanes::Set(1);
+	Vector contradiction = Lanes::Zero();
+	for (;;)
+	{
+		Vector changed = Lanes::Zero();
+		// placed digits leave the candidates of every other cell in the unit
+		for (const auto& unit : sudokuTables.units)
+		{
+			Vector placed = Lanes::Zero();
+			for (int cell : unit)
+			{
+				contradiction = Lanes::Or(contradiction, Lanes::And(placed, solved[cell]));
+				placed = Lanes::Or(placed, solved[cell]);
+			}
+			for (int cell : unit)
+			{
+				const Vector next = Lanes::AndNot(Lanes::AndNot(solved[cell], placed), candidates[cell]);
+				changed = Lanes::Or(changed, Lanes::Xor(next, candidates[cell]));
+				candidates[cell] = next;
+			}
+		}
+		// naked singles
+		for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+		{
+			const Vector mask = candidates[cell];
+			const Vector empty = Lanes::IsZero(mask);
+			const Vector single = Lanes::AndNot(empty, Lanes::IsZero(Lanes::And(mask, Lanes::Sub(mask, one))));
+			const Vector next = Lanes::Or(solved[cell], Lanes::And(single, mask));
+			changed = Lanes::Or(changed, Lanes::Xor(next, solved[cell]));
+			solved[cell] = next;
+			contradiction = Lanes::Or(contradiction, empty);
+		}
+		// hidden singles, a cell holding two of them or a unit missing a digit is a contradiction
+		for (const auto& unit : sudokuTables.units)
+		{
+			Vector once = Lanes::Zero();
+			Vector twice = Lanes::Zero();
+			for (int cell : unit)
+			{
+				twice = Lanes::Or(twice, Lanes::And(once, candidates[cell]));
+				once = Lanes::Or(once, candidates[cell]);
+			}
+			contradiction = Lanes::Or(contradiction, Lanes::AndNot(once, allDigits));
+			const Vector hidden = Lanes::AndNot(twice, once);
+			for (int cell : unit)
+			{
+				const Vector single = Lanes::And(candidates[cell], hidden);
+				contradiction = Lanes::Or(contradiction, Lanes::AndNot(Lanes::IsZero(Lanes::And(single, Lanes::Sub(single, one))), allDigits));
+				const Vector next = Lanes::Select(Lanes::IsZero(single), candidates[cell], single);
+				changed = Lanes::Or(changed, Lanes::Xor(next, candidates[cell]));
+				candidates[cell] = next;
+			}
+		}
+		if (!Lanes::Any(changed))
+		{
+			break;
+		}
+	}
+	for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+	{
+		Lanes::Store(solvedData + cell * WIDTH, solved[cell]);
+		Lanes::Store(candidatesData + cell * WIDTH, candidates[cell]);
+	}
+	Lanes::Store(contradictionData, contradiction);
+}
+
+void propagateSse41(uint16_t* solved, uint16_t* candidates, uint16_t* contradiction);
+void propagateAvx2(uint16_t* solved, uint16_t* candidates, uint16_t* contradiction);
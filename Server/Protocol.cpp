@@ -0,0 +1,1458 @@
+#include "Protocol.h"
+#include <assert.h>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	enum class ValueKind : uint8_t
+	{
+		null,
+		booleanFalse,
+		booleanTrue,
+		integer,
+		number,
+		string,
+		decimal,
+		array,
+		object
+	};
+
+	constexpr const int MAX_DEPTH = 8;
+
+	constexpr const char* MESSAGE_TYPE_NAMES[] = {
+		"", "connect", "error", "serverConfig", "usersList", "addUser", "changeUser", "removeUser",
+		"roomsList", "addRoom", "removeRoom", "changeRoom", "createRoom", "join", "lock", "quit", "start",
+		"ready", "placeDigit", "move", "finish", "hint", "listRooms", "roomsPage", "stats"
+	};
+	static_assert(sizeof(MESSAGE_TYPE_NAMES) / sizeof(*MESSAGE_TYPE_NAMES) == size_t(MessageType::count), "missing message type name");
+
+	constexpr const char* FIELD_NAMES[] = {
+		"", "name", "reason", "encoding", "roomId", "roomIds", "names", "id", "ids", "host", "hosts",
+		"guest", "guests", "locked", "locks", "lock", "change", "difficulty", "as", "puzzle",
+		"ready", "cell", "digit", "correct", "points", "lifes", "countdown", "winner", "technique", "cells",
+		"epoch", "version", "cursor", "limit", "open", "unlocked", "difficulties"
+	};
+	static_assert(sizeof(FIELD_NAMES) / sizeof(*FIELD_NAMES) == size_t(Field::count), "missing field name");
+
+	void appendVarint(std::string& destination, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			destination.push_back(static_cast<char>((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		destination.push_back(static_cast<char>(value));
+	}
+
+	bool readVarint(const unsigned char*& data, const unsigned char* end, uint64_t& value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 64 && data != end; shift += 7)
+		{
+			unsigned char byte = *data++;
+			value |= uint64_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void appendBinaryString(std::string& destination, const std::string& value)
+	{
+		appendVarint(destination, value.size());
+		destination.append(value);
+	}
+
+	// both decoders reject malformed utf-8, so names that reach other clients stay encodable
+	bool skipUtf8(const char*& data, const char* end)
+	{
+		const unsigned char lead = static_cast<unsigned char>(*data);
+		size_t length = 0;
+		unsigned int codePoint = 0;
+		unsigned int minimum = 0;
+		if ((lead & 0xE0) == 0xC0)
+		{
+			length = 2;
+			codePoint = lead & 0x1F;
+			minimum = 0x80;
+		}
+		else if ((lead & 0xF0) == 0xE0)
+		{
+			length = 3;
+			codePoint = lead & 0x0F;
+			minimum = 0x800;
+		}
+		else if ((lead & 0xF8) == 0xF0)
+		{
+			length = 4;
+			codePoint = lead & 0x07;
+			minimum = 0x10000;
+		}
+		else
+		{
+			return false;
+		}
+		if (size_t(end - data) < length)
+		{
+			return false;
+		}
+		for (size_t i = 1; i < length; ++i)
+		{
+			const unsigned char byte = static_cast<unsigned char>(data[i]);
+			if ((byte & 0xC0) != 0x80)
+			{
+				return false;
+			}
+			codePoint = (codePoint << 6) | (byte & 0x3F);
+		}
+		if (codePoint < minimum || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+		{
+			return false;
+		}
+		data += length;
+		return true;
+	}
+
+	bool readBinaryString(const unsigned char*& data, const unsigned char* end, std::string& value)
+	{
+		uint64_t size = 0;
+		if (!readVarint(data, end, size) || size > uint64_t(end - data))
+		{
+			return false;
+		}
+		const char* begin = reinterpret_cast<const char*>(data);
+		const char* stringEnd = begin + size;
+		for (const char* c = begin; c != stringEnd;)
+		{
+			if (static_cast<unsigned char>(*c) < 0x80)
+			{
+				++c;
+			}
+			else if (!skipUtf8(c, stringEnd))
+			{
+				return false;
+			}
+		}
+		value.assign(begin, stringEnd);
+		data += size;
+		return true;
+	}
+
+	void appendJsonString(std::string& destination, const std::string& value)
+	{
+		static constexpr const char* HEX = "0123456789abcdef";
+		destination.push_back('"');
+		for (char c : value)
+		{
+			switch (c)
+			{
+			case '"':
+				destination.append("\\\"");
+				break;
+			case '\\':
+				destination.append("\\\\");
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					destination.append("\\u00");
+					destination.push_back(HEX[(c >> 4) & 0xF]);
+					destination.push_back(HEX[c & 0xF]);
+				}
+				else
+				{
+					destination.push_back(c);
+				}
+			}
+		}
+		destination.push_back('"');
+	}
+
+	bool isDecimal(const std::string& value)
+	{
+		if (value.empty() || value.size() > 9 || (value[0] == '0' && value.size() > 1))
+		{
+			return false;
+		}
+		for (char c : value)
+		{
+			if (c < '0' || c > '9')
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void appendBinaryKey(std::string& destination, const std::string& key)
+	{
+		Field field = toField(key);
+		destination.push_back(static_cast<char>(field));
+		if (field == Field::literal)
+		{
+			appendBinaryString(destination, key);
+		}
+	}
+
+	bool readBinaryKey(const unsigned char*& data, const unsigned char* end, std::string& key)
+	{
+		if (data == end || *data >= uint8_t(Field::count))
+		{
+			return false;
+		}
+		Field field = static_cast<Field>(*data++);
+		if (field == Field::literal)
+		{
+			return readBinaryString(data, end, key);
+		}
+		key = toString(field);
+		return true;
+	}
+
+	void appendBinaryValue(std::string& destination, const Json& value)
+	{
+		switch (value.type())
+		{
+		case Json::value_t::boolean:
+			destination.push_back(static_cast<char>(value.get<bool>() ? ValueKind::booleanTrue : ValueKind::booleanFalse));
+			break;
+		case Json::value_t::number_integer:
+		case Json::value_t::number_unsigned:
+		{
+			long long integer = value.get<long long>();
+			destination.push_back(static_cast<char>(ValueKind::integer));
+			appendVarint(destination, (uint64_t(integer) << 1) ^ uint64_t(integer >> 63));
+			break;
+		}
+		case Json::value_t::number_float:
+		{
+			double number = value.get<double>();
+			char bytes[sizeof(double)];
+			std::memcpy(bytes, &number, sizeof(double));
+			destination.push_back(static_cast<char>(ValueKind::number));
+			destination.append(bytes, sizeof(double));
+			break;
+		}
+		case Json::value_t::string:
+		{
+			const std::string& string = value.get_ref<const std::string&>();
+			if (isDecimal(string))
+			{
+				destination.push_back(static_cast<char>(ValueKind::decimal));
+				appendVarint(destination, std::stoul(string));
+			}
+			else
+			{
+				destination.push_back(static_cast<char>(ValueKind::string));
+				appendBinaryString(destination, string);
+			}
+			break;
+		}
+		case Json::value_t::array:
+			destination.push_back(static_cast<char>(ValueKind::array));
+			appendVarint(destination, value.size());
+			for (const Json& element : value)
+			{
+				appendBinaryValue(destination, element);
+			}
+			break;
+		case Json::value_t::object:
+			destination.push_back(static_cast<char>(ValueKind::object));
+			appendVarint(destination, value.size());
+			for (const auto& item : value.items())
+			{
+				appendBinaryKey(destination, item.key());
+				appendBinaryValue(destination, item.value());
+			}
+			break;
+		default:
+			destination.push_back(static_cast<char>(ValueKind::null));
+		}
+	}
+
+	bool readBinaryValue(const unsigned char*& data, const unsigned char* end, Json& value, int depth)
+	{
+		if (data == end || depth > MAX_DEPTH)
+		{
+			return false;
+		}
+		uint64_t integer = 0;
+		switch (static_cast<ValueKind>(*data++))
+		{
+		case ValueKind::null:
+			value = nullptr;
+			return true;
+		case ValueKind::booleanFalse:
+			value = false;
+			return true;
+		case ValueKind::booleanTrue:
+			value = true;
+			return true;
+		case ValueKind::integer:
+			if (!readVarint(data, end, integer))
+			{
+				return false;
+			}
+			value = static_cast<long long>(integer >> 1) ^ -static_cast<long long>(integer & 1);
+			return true;
+		case ValueKind::number:
+		{
+			if (end - data < ptrdiff_t(sizeof(double)))
+			{
+				return false;
+			}
+			double number;
+			std::memcpy(&number, data, sizeof(double));
+			data += sizeof(double);
+			value = number;
+			return true;
+		}
+		case ValueKind::string:
+		{
+			std::string string;
+			if (!readBinaryString(data, end, string))
+			{
+				return false;
+			}
+			value = std::move(string);
+			return true;
+		}
+		case ValueKind::decimal:
+			if (!readVarint(data, end, integer))
+			{
+				return false;
+			}
+			value = std::to_string(integer);
+			return true;
+		case ValueKind::array:
+		{
+			uint64_t size = 0;
+			if (!readVarint(data, end, size) || size > uint64_t(end - data))
+			{
+				return false;
+			}
+			value = Json::array();
+			for (uint64_t i = 0; i < size; ++i)
+			{
+				Json element;
+				if (!readBinaryValue(data, end, element, depth + 1))
+				{
+					return false;
+				}
+				value.push_back(std::move(element));
+			}
+			return true;
+		}
+		case ValueKind::object:
+		{
+			uint64_t size = 0;
+			if (!readVarint(data, end, size) || size > uint64_t(end - data))
+			{
+				return false;
+			}
+			value = Json::object();
+			for (uint64_t i = 0; i < size; ++i)
+			{
+				std::string key;
+				if (!readBinaryKey(data, end, key) || !readBinaryValue(data, end, value[key], depth + 1))
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	bool skipBinaryString(const unsigned char*& data, const unsigned char* end)
+	{
+		uint64_t size = 0;
+		if (!readVarint(data, end, size) || size > uint64_t(end - data))
+		{
+			return false;
+		}
+		data += size;
+		return true;
+	}
+
+	bool skipBinaryKey(const unsigned char*& data, const unsigned char* end)
+	{
+		if (data == end || *data >= uint8_t(Field::count))
+		{
+			return false;
+		}
+		return static_cast<Field>(*data++) != Field::literal || skipBinaryString(data, end);
+	}
+
+	bool skipBinaryValue(const unsigned char*& data, const unsigned char* end, int depth)
+	{
+		if (data == end || depth > MAX_DEPTH)
+		{
+			return false;
+		}
+		uint64_t size = 0;
+		switch (static_cast<ValueKind>(*data++))
+		{
+		case ValueKind::null:
+		case ValueKind::booleanFalse:
+		case ValueKind::booleanTrue:
+			return true;
+		case ValueKind::integer:
+		case ValueKind::decimal:
+			return readVarint(data, end, size);
+		case ValueKind::number:
+			if (end - data < ptrdiff_t(sizeof(double)))
+			{
+				return false;
+			}
+			data += sizeof(double);
+			return true;
+		case ValueKind::string:
+			return skipBinaryString(data, end);
+		case ValueKind::array:
+			if (!readVarint(data, end, size) || size > uint64_t(end - data))
+			{
+				return false;
+			}
+			for (uint64_t i = 0; i < size; ++i)
+			{
+				if (!skipBinaryValue(data, end, depth + 1))
+				{
+					return false;
+				}
+			}
+			return true;
+		case ValueKind::object:
+			if (!readVarint(data, end, size) || size > uint64_t(end - data))
+			{
+				return false;
+			}
+			for (uint64_t i = 0; i < size; ++i)
+			{
+				if (!skipBinaryKey(data, end) || !skipBinaryValue(data, end, depth + 1))
+				{
+					return false;
+				}
+			}
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// strings that look like room ids travel as decimals
+	bool readBinaryText(const unsigned char*& data, const unsigned char* end, std::string& value)
+	{
+		if (data == end)
+		{
+			return false;
+		}
+		const ValueKind kind = static_cast<ValueKind>(*data++);
+		uint64_t decimal = 0;
+		if (kind == ValueKind::string)
+		{
+			return readBinaryString(data, end, value);
+		}
+		if (kind != ValueKind::decimal || !readVarint(data, end, decimal))
+		{
+			return false;
+		}
+		value = std::to_string(decimal);
+		return true;
+	}
+
+	bool readBinaryBoolean(const unsigned char*& data, const unsigned char* end, bool& value)
+	{
+		if (data == end || (*data != uint8_t(ValueKind::booleanFalse) && *data != uint8_t(ValueKind::booleanTrue)))
+		{
+			return false;
+		}
+		value = *data++ == uint8_t(ValueKind::booleanTrue);
+		return true;
+	}
+
+	template<typename Integer>
+	bool readBinaryInteger(const unsigned char*& data, const unsigned char* end, Integer& value, bool allowDecimal)
+	{
+		if (data == end)
+		{
+			return false;
+		}
+		const ValueKind kind = static_cast<ValueKind>(*data++);
+		uint64_t integer = 0;
+		if ((kind != ValueKind::integer && (kind != ValueKind::decimal || !allowDecimal)) || !readVarint(data, end, integer))
+		{
+			return false;
+		}
+		if (kind == ValueKind::decimal)
+		{
+			if (integer > uint64_t(std::numeric_limits<Integer>::max()))
+			{
+				return false;
+			}
+			value = Integer(integer);
+			return true;
+		}
+		const long long number = static_cast<long long>(integer >> 1) ^ -static_cast<long long>(integer & 1);
+		if (number < std::numeric_limits<Integer>::min() || number > std::numeric_limits<Integer>::max())
+		{
+			return false;
+		}
+		value = Integer(number);
+		return true;
+	}
+
+	bool readBinaryField(const unsigned char*& data, const unsigned char* end, Field field, Request& request)
+	{
+		switch (field)
+		{
+		case Field::name:
+			return readBinaryText(data, end, request.name);
+		case Field::encoding:
+		{
+			std::string encoding;
+			if (!readBinaryText(data, end, encoding))
+			{
+				return false;
+			}
+			request.encoding = toEncoding(encoding);
+			return true;
+		}
+		case Field::roomId:
+			return readBinaryInteger(data, end, request.roomId, true);
+		case Field::lock:
+			return readBinaryBoolean(data, end, request.lock);
+		case Field::change:
+			return readBinaryText(data, end, request.change);
+		case Field::difficulty:
+			return readBinaryInteger(data, end, request.difficulty, false);
+		case Field::ready:
+			return readBinaryBoolean(data, end, request.ready);
+		case Field::cell:
+			return readBinaryInteger(data, end, request.cell, false);
+		case Field::digit:
+			return readBinaryInteger(data, end, request.digit, false);
+		case Field::epoch:
+			return readBinaryInteger(data, end, request.epoch, false);
+		case Field::version:
+			return readBinaryInteger(data, end, request.version, false);
+		case Field::cursor:
+			return readBinaryInteger(data, end, request.cursor, true);
+		case Field::limit:
+			return readBinaryInteger(data, end, request.limit, false);
+		case Field::open:
+			return readBinaryBoolean(data, end, request.open);
+		case Field::unlocked:
+			return readBinaryBoolean(data, end, request.unlocked);
+		default:
+			return skipBinaryValue(data, end, 1);
+		}
+	}
+
+	bool decodeBinaryRequest(const char* data, size_t size, Request& request)
+	{
+		const unsigned char* begin = reinterpret_cast<const unsigned char*>(data);
+		const unsigned char* end = begin + size;
+		if (begin == end || *begin >= uint8_t(MessageType::count))
+		{
+			return false;
+		}
+		request.type = static_cast<MessageType>(*begin++);
+		if (request.type == MessageType::unknown)
+		{
+			return true;
+		}
+		if (begin == end)
+		{
+			return false;
+		}
+		unsigned int fieldCount = *begin++;
+		for (unsigned int i = 0; i < fieldCount; ++i)
+		{
+			if (begin == end || *begin >= uint8_t(Field::count))
+			{
+				return false;
+			}
+			const Field field = static_cast<Field>(*begin++);
+			if ((field == Field::literal && !skipBinaryString(begin, end)) || !readBinaryField(begin, end, field, request))
+			{
+				return false;
+			}
+			request.fields |= uint64_t(1) << size_t(field);
+		}
+		return begin == end;
+	}
+
+	void skipJsonWhitespace(const char*& data, const char* end)
+	{
+		while (data != end && (*data == ' ' || *data == '\t' || *data == '\n' || *data == '\r'))
+		{
+			++data;
+		}
+	}
+
+	bool readJsonLiteral(const char*& data, const char* end, const char* literal)
+	{
+		const size_t length = std::strlen(literal);
+		if (size_t(end - data) < length || std::memcmp(data, literal, length) != 0)
+		{
+			return false;
+		}
+		data += length;
+		return true;
+	}
+
+	bool readHex(const char*& data, const char* end, unsigned int& value)
+	{
+		if (end - data < 4)
+		{
+			return false;
+		}
+		value = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			const char c = *data++;
+			value <<= 4;
+			if (c >= '0' && c <= '9')
+			{
+				value |= unsigned(c - '0');
+			}
+			else if (c >= 'a' && c <= 'f')
+			{
+				value |= unsigned(c - 'a' + 10);
+			}
+			else if (c >= 'A' && c <= 'F')
+			{
+				value |= unsigned(c - 'A' + 10);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void appendUtf8(std::string& destination, unsigned int codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			destination.push_back(static_cast<char>(codePoint));
+		}
+		else if (codePoint < 0x800)
+		{
+			destination.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+			destination.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+		else if (codePoint < 0x10000)
+		{
+			destination.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+			destination.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+			destination.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+		else
+		{
+			destination.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+			destination.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+			destination.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+			destination.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+	}
+
+	// a null value only validates the string
+	bool readJsonString(const char*& data, const char* end, std::string* value)
+	{
+		if (data == end || *data != '"')
+		{
+			return false;
+		}
+		++data;
+		if (value)
+		{
+			value->clear();
+		}
+		while (data != end)
+		{
+			const unsigned char c = static_cast<unsigned char>(*data);
+			if (c == '"')
+			{
+				++data;
+				return true;
+			}
+			if (c < 0x20)
+			{
+				return false;
+			}
+			if (c >= 0x80)
+			{
+				const char* sequence = data;
+				if (!skipUtf8(data, end))
+				{
+					return false;
+				}
+				if (value)
+				{
+					value->append(sequence, data);
+				}
+				continue;
+			}
+			++data;
+			if (c != '\\')
+			{
+				if (value)
+				{
+					value->push_back(static_cast<char>(c));
+				}
+				continue;
+			}
+			if (data == end)
+			{
+				return false;
+			}
+			unsigned int codePoint = 0;
+			switch (*data++)
+			{
+			case '"':
+				codePoint = '"';
+				break;
+			case '\\':
+				codePoint = '\\';
+				break;
+			case '/':
+				codePoint = '/';
+				break;
+			case 'b':
+				codePoint = '\b';
+				break;
+			case 'f':
+				codePoint = '\f';
+				break;
+			case 'n':
+				codePoint = '\n';
+				break;
+			case 'r':
+				codePoint = '\r';
+				break;
+			case 't':
+				codePoint = '\t';
+				break;
+			case 'u':
+			{
+				if (!readHex(data, end, codePoint) || (codePoint >= 0xDC00 && codePoint <= 0xDFFF))
+				{
+					return false;
+				}
+				if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+				{
+					unsigned int low = 0;
+					if (end - data < 2 || data[0] != '\\' || data[1] != 'u')
+					{
+						return false;
+					}
+					data += 2;
+					if (!readHex(data, end, low) || low < 0xDC00 || low > 0xDFFF)
+					{
+						return false;
+					}
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				break;
+			}
+			default:
+				return false;
+			}
+			if (value)
+			{
+				appendUtf8(*value, codePoint);
+			}
+		}
+		return false;
+	}
+
+	// integral is cleared for fractions, exponents and integers too large to keep
+	bool readJsonNumber(const char*& data, const char* end, long long& value, bool& integral)
+	{
+		const bool negative = data != end && *data == '-';
+		if (negative)
+		{
+			++data;
+		}
+		if (data == end || *data < '0' || *data > '9')
+		{
+			return false;
+		}
+		integral = true;
+		unsigned long long magnitude = 0;
+		if (*data == '0')
+		{
+			++data;
+		}
+		else
+		{
+			while (data != end && *data >= '0' && *data <= '9')
+			{
+				if (magnitude >= 100000000000000000ull)
+				{
+					integral = false;
+				}
+				else
+				{
+					magnitude = magnitude * 10 + unsigned(*data - '0');
+				}
+				++data;
+			}
+		}
+		if (data != end && *data == '.')
+		{
+			integral = false;
+			if (++data == end || *data < '0' || *data > '9')
+			{
+				return false;
+			}
+			while (data != end && *data >= '0' && *data <= '9')
+			{
+				++data;
+			}
+		}
+		if (data != end && (*data == 'e' || *data == 'E'))
+		{
+			integral = false;
+			if (++data != end && (*data == '+' || *data == '-'))
+			{
+				++data;
+			}
+			if (data == end || *data < '0' || *data > '9')
+			{
+				return false;
+			}
+			while (data != end && *data >= '0' && *data <= '9')
+			{
+				++data;
+			}
+		}
+		value = negative ? -static_cast<long long>(magnitude) : static_cast<long long>(magnitude);
+		return true;
+	}
+
+	bool skipJsonValue(const char*& data, const char* end, int depth)
+	{
+		if (data == end || depth > MAX_DEPTH)
+		{
+			return false;
+		}
+		switch (*data)
+		{
+		case '"':
+			return readJsonString(data, end, nullptr);
+		case 't':
+			return readJsonLiteral(data, end, "true");
+		case 'f':
+			return readJsonLiteral(data, end, "false");
+		case 'n':
+			return readJsonLiteral(data, end, "null");
+		case '[':
+		case '{':
+		{
+			const bool object = *data++ == '{';
+			const char close = object ? '}' : ']';
+			skipJsonWhitespace(data, end);
+			if (data != end && *data == close)
+			{
+				++data;
+				return true;
+			}
+			while (true)
+			{
+				if (object)
+				{
+					if (!readJsonString(data, end, nullptr))
+					{
+						return false;
+					}
+					skipJsonWhitespace(data, end);
+					if (data == end || *data++ != ':')
+					{
+						return false;
+					}
+					skipJsonWhitespace(data, end);
+				}
+				if (!skipJsonValue(data, end, depth + 1))
+				{
+					return false;
+				}
+				skipJsonWhitespace(data, end);
+				if (data == end)
+				{
+					return false;
+				}
+				const char separator = *data++;
+				if (separator == close)
+				{
+					return true;
+				}
+				if (separator != ',')
+				{
+					return false;
+				}
+				skipJsonWhitespace(data, end);
+			}
+		}
+		default:
+		{
+			long long number = 0;
+			bool integral = false;
+			return readJsonNumber(data, end, number, integral);
+		}
+		}
+	}
+
+	bool readJsonBoolean(const char*& data, const char* end, bool& value)
+	{
+		if (readJsonLiteral(data, end, "true"))
+		{
+			value = true;
+			return true;
+		}
+		if (readJsonLiteral(data, end, "false"))
+		{
+			value = false;
+			return true;
+		}
+		return false;
+	}
+
+	// requests carry room ids as numbers, everything the server sends has them as strings
+	template<typename Integer>
+	bool readJsonInteger(const char*& data, const char* end, Integer& value, bool allowDecimal)
+	{
+		if (allowDecimal && data != end && *data == '"')
+		{
+			std::string decimal;
+			if (!readJsonString(data, end, &decimal) || !isDecimal(decimal))
+			{
+				return false;
+			}
+			value = Integer(std::stoi(decimal));
+			return true;
+		}
+		long long number = 0;
+		bool integral = false;
+		if (!readJsonNumber(data, end, number, integral) || !integral ||
+			number < std::numeric_limits<Integer>::min() || number > std::numeric_limits<Integer>::max())
+		{
+			return false;
+		}
+		value = Integer(number);
+		return true;
+	}
+
+	bool readJsonField(const char*& data, const char* end, Field field, Request& request)
+	{
+		switch (field)
+		{
+		case Field::name:
+			return readJsonString(data, end, &request.name);
+		case Field::encoding:
+		{
+			std::string encoding;
+			if (!readJsonString(data, end, &encoding))
+			{
+				return false;
+			}
+			request.encoding = toEncoding(encoding);
+			return true;
+		}
+		case Field::roomId:
+			return readJsonInteger(data, end, request.roomId, true);
+		case Field::lock:
+			return readJsonBoolean(data, end, request.lock);
+		case Field::change:
+			return readJsonString(data, end, &request.change);
+		case Field::difficulty:
+			return readJsonInteger(data, end, request.difficulty, false);
+		case Field::ready:
+			return readJsonBoolean(data, end, request.ready);
+		case Field::cell:
+			return readJsonInteger(data, end, request.cell, false);
+		case Field::digit:
+			return readJsonInteger(data, end, request.digit, false);
+		case Field::epoch:
+			return readJsonInteger(data, end, request.epoch, false);
+		case Field::version:
+			return readJsonInteger(data, end, request.version, false);
+		case Field::cursor:
+			return readJsonInteger(data, end, request.cursor, true);
+		case Field::limit:
+			return readJsonInteger(data, end, request.limit, false);
+		case Field::open:
+			return readJsonBoolean(data, end, request.open);
+		case Field::unlocked:
+			return readJsonBoolean(data, end, request.unlocked);
+		default:
+			return skipJsonValue(data, end, 1);
+		}
+	}
+
+	bool decodeJsonRequest(const char* data, size_t size, Request& request)
+	{
+		const char* end = data + size;
+		skipJsonWhitespace(data, end);
+		if (data == end || *data++ != '{')
+		{
+			return false;
+		}
+		skipJsonWhitespace(data, end);
+		if (data != end && *data == '}')
+		{
+			++data;
+		}
+		else
+		{
+			std::string key;
+			while (true)
+			{
+				if (!readJsonString(data, end, &key))
+				{
+					return false;
+				}
+				skipJsonWhitespace(data, end);
+				if (data == end || *data++ != ':')
+				{
+					return false;
+				}
+				skipJsonWhitespace(data, end);
+				if (key == "type")
+				{
+					// a type that is not a string is as unknown as a name that is not in the table
+					std::string type;
+					if (data != end && *data == '"' ? !readJsonString(data, end, &type) : !skipJsonValue(data, end, 1))
+					{
+						return false;
+					}
+					request.type = toMessageType(type);
+				}
+				else
+				{
+					const Field field = toField(key);
+					if (!readJsonField(data, end, field, request))
+					{
+						return false;
+					}
+					if (field != Field::literal)
+					{
+						request.fields |= uint64_t(1) << size_t(field);
+					}
+				}
+				skipJsonWhitespace(data, end);
+				if (data == end)
+				{
+					return false;
+				}
+				const char separator = *data++;
+				if (separator == '}')
+				{
+					break;
+				}
+				if (separator != ',')
+				{
+					return false;
+				}
+				skipJsonWhitespace(data, end);
+			}
+		}
+		skipJsonWhitespace(data, end);
+		return data == end;
+	}
+}
+
+const char* toString(Encoding encoding)
+{
+	return encoding == Encoding::binary ? "binary" : "json";
+}
+
+const char* toString(MessageType type)
+{
+	return MESSAGE_TYPE_NAMES[size_t(type)];
+}
+
+const char* toString(Field field)
+{
+	return FIELD_NAMES[size_t(field)];
+}
+
+Encoding toEncoding(const std::string& encoding)
+{
+	return encoding == "binary" ? Encoding::binary : Encoding::json;
+}
+
+MessageType toMessageType(const std::string& type)
+{
+	for (size_t i = 1; i < size_t(MessageType::count); ++i)
+	{
+		if (type == MESSAGE_TYPE_NAMES[i])
+		{
+			return static_cast<MessageType>(i);
+		}
+	}
+	return MessageType::unknown;
+}
+
+Field toField(const std::string& field)
+{
+	for (size_t i = 1; i < size_t(Field::count); ++i)
+	{
+		if (field == FIELD_NAMES[i])
+		{
+			return static_cast<Field>(i);
+		}
+	}
+	return Field::literal;
+}
+
+std::string encodeMessage(const Json& message, Encoding encoding)
+{
+	assert(message.is_object());
+	if (encoding == Encoding::json)
+	{
+		return message.dump();
+	}
+	std::string buffer;
+	auto typeIt = message.find("type");
+	std::string typeName = typeIt != message.end() && typeIt->is_string() ? typeIt->get<std::string>() : "";
+	MessageType type = toMessageType(typeName);
+	buffer.push_back(static_cast<char>(type));
+	if (type == MessageType::unknown)
+	{
+		appendBinaryString(buffer, typeName);
+	}
+	size_t fieldCount = message.size() - (typeIt != message.end() ? 1 : 0);
+	assert(fieldCount <= 0xFF);
+	buffer.push_back(static_cast<char>(fieldCount));
+	for (const auto& item : message.items())
+	{
+		if (item.key() != "type")
+		{
+			appendBinaryKey(buffer, item.key());
+			appendBinaryValue(buffer, item.value());
+		}
+	}
+	return buffer;
+}
+
+Result decodeMessage(const char* data, size_t size, Encoding encoding, Json& message)
+{
+	MessageType type = MessageType::unknown;
+	return decodeMessage(data, size, encoding, message, type);
+}
+
+Result decodeMessage(const char* data, size_t size, Encoding encoding, Json& message, MessageType& type)
+{
+	type = MessageType::unknown;
+	if (encoding == Encoding::json)
+	{
+		message = Json::parse(data, data + size, nullptr, false);
+		if (!message.is_object())
+		{
+			return Result::genericError;
+		}
+		auto typeIt = message.find("type");
+		if (typeIt != message.end() && typeIt->is_string())
+		{
+			type = toMessageType(typeIt->get_ref<const std::string&>());
+		}
+		return Result::success;
+	}
+	const unsigned char* begin = reinterpret_cast<const unsigned char*>(data);
+	const unsigned char* end = begin + size;
+	if (begin == end || *begin >= uint8_t(MessageType::count))
+	{
+		return Result::genericError;
+	}
+	type = static_cast<MessageType>(*begin++);
+	std::string typeName = toString(type);
+	if (type == MessageType::unknown && !readBinaryString(begin, end, typeName))
+	{
+		return Result::genericError;
+	}
+	if (begin == end)
+	{
+		return Result::genericError;
+	}
+	unsigned int fieldCount = *begin++;
+	message = Json::object();
+	message["type"] = typeName;
+	for (unsigned int i = 0; i < fieldCount; ++i)
+	{
+		std::string key;
+		if (!readBinaryKey(begin, end, key) || !readBinaryValue(begin, end, message[key], 1))
+		{
+			return Result::genericError;
+		}
+	}
+	return begin == end ? Result::success : Result::genericError;
+}
+
+bool Request::Has(Field field) const
+{
+	return (fields >> size_t(field)) & 1;
+}
+
+Result decodeRequest(const char* data, size_t size, Encoding encoding, Request& request)
+{
+	request = Request();
+	const bool decoded = encoding == Encoding::json ? decodeJsonRequest(data, size, request) : decodeBinaryRequest(data, size, request);
+	if (!decoded)
+	{
+		return Result::genericError;
+	}
+	if (request.type == MessageType::unknown)
+	{
+		// only a message the typed fields cannot describe pays for the json tree
+		return decodeMessage(data, size, encoding, request.message);
+	}
+	return Result::success;
+}
+
+MessageType peekMessageType(const char* data, size_t size, Encoding encoding)
+{
+	if (encoding == Encoding::json || size == 0 || uint8_t(*data) >= uint8_t(MessageType::count))
+	{
+		return MessageType::unknown;
+	}
+	return static_cast<MessageType>(*data);
+}
+
+MessageWriter::MessageWriter(Encoding encoding, MessageType type)
+	: encoding(encoding)
+{
+	assert(type != MessageType::unknown);
+	if (encoding == Encoding::json)
+	{
+		buffer.append("{\"type\":\"");
+		buffer.append(toString(type));
+		buffer.push_back('"');
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(type));
+		fieldCountOffset = buffer.size();
+		buffer.push_back(0);
+	}
+}
+
+MessageWriter& MessageWriter::Integer(Field field, long long value)
+{
+	BeginField(field);
+	WriteInteger(value);
+	return *this;
+}
+
+MessageWriter& MessageWriter::Boolean(Field field, bool value)
+{
+	BeginField(field);
+	BooleanElement(value);
+	return *this;
+}
+
+MessageWriter& MessageWriter::String(Field field, const std::string& value)
+{
+	BeginField(field);
+	if (encoding == Encoding::json)
+	{
+		appendJsonString(buffer, value);
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(ValueKind::string));
+		appendBinaryString(buffer, value);
+	}
+	return *this;
+}
+
+MessageWriter& MessageWriter::RoomId(Field field, int roomId)
+{
+	assert(roomId >= 0);
+	BeginField(field);
+	if (encoding == Encoding::json)
+	{
+		buffer.push_back('"');
+		buffer.append(std::to_string(roomId));
+		buffer.push_back('"');
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(ValueKind::decimal));
+		appendVarint(buffer, uint64_t(roomId));
+	}
+	return *this;
+}
+
+MessageWriter& MessageWriter::Value(const std::string& key, const Json& value)
+{
+	++fieldCount;
+	if (encoding == Encoding::json)
+	{
+		buffer.push_back(',');
+		appendJsonString(buffer, key);
+		buffer.push_back(':');
+		buffer.append(value.dump());
+	}
+	else
+	{
+		appendBinaryKey(buffer, key);
+		appendBinaryValue(buffer, value);
+	}
+	return *this;
+}
+
+MessageWriter& MessageWriter::BeginArray(Field field, size_t size)
+{
+	BeginField(field);
+	if (encoding == Encoding::json)
+	{
+		buffer.push_back('[');
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(ValueKind::array));
+		appendVarint(buffer, size);
+	}
+	firstElement = true;
+	return *this;
+}
+
+MessageWriter& MessageWriter::BooleanElement(bool value)
+{
+	BeginElement();
+	if (encoding == Encoding::json)
+	{
+		buffer.append(value ? "true" : "false");
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(value ? ValueKind::booleanTrue : ValueKind::booleanFalse));
+	}
+	return *this;
+}
+
+MessageWriter& MessageWriter::StringElement(const std::string& value)
+{
+	BeginElement();
+	if (encoding == Encoding::json)
+	{
+		appendJsonString(buffer, value);
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(ValueKind::string));
+		appendBinaryString(buffer, value);
+	}
+	return *this;
+}
+
+MessageWriter& MessageWriter::RoomIdElement(int roomId)
+{
+	BeginElement();
+	if (encoding == Encoding::json)
+	{
+		buffer.push_back('"');
+		buffer.append(std::to_string(roomId));
+		buffer.push_back('"');
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(ValueKind::decimal));
+		appendVarint(buffer, uint64_t(roomId));
+	}
+	return *this;
+}
+
+MessageWriter& MessageWriter::IntegerElement(long long value)
+{
+	BeginElement();
+	WriteInteger(value);
+	return *this;
+}
+
+MessageWriter& MessageWriter::EndArray()
+{
+	if (encoding == Encoding::json)
+	{
+		buffer.push_back(']');
+	}
+	firstElement = true;
+	return *this;
+}
+
+const std::string& MessageWriter::Finish()
+{
+	if (!finished)
+	{
+		finished = true;
+		if (encoding == Encoding::json)
+		{
+			buffer.push_back('}');
+		}
+		else
+		{
+			assert(fieldCount <= 0xFF);
+			buffer[fieldCountOffset] = static_cast<char>(fieldCount);
+		}
+	}
+	return buffer;
+}
+
+std::string MessageWriter::Release()
+{
+	Finish();
+	return std::move(buffer);
+}
+
+Encoding MessageWriter::GetEncoding() const
+{
+	return encoding;
+}
+
+void MessageWriter::BeginField(Field field)
+{
+	assert(field != Field::literal);
+	++fieldCount;
+	if (encoding == Encoding::json)
+	{
+		buffer.append(",\"");
+		buffer.append(toString(field));
+		buffer.append("\":");
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(field));
+	}
+	firstElement = true;
+}
+
+void MessageWriter::WriteInteger(long long value)
+{
+	if (encoding == Encoding::json)
+	{
+		buffer.append(std::to_string(value));
+	}
+	else
+	{
+		buffer.push_back(static_cast<char>(ValueKind::integer));
+		appendVarint(buffer, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+	}
+}
+
+void MessageWriter::BeginElement()
+{
+	if (encoding == Encoding::json && !firstElement)
+	{
+		buffer.push_back(',');
+	}
+	firstElement = false;
+}
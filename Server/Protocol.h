@@ -0,0 +1,157 @@
+#pragma once
+#include "Result.h"
+#include "Json.h"
+#include <cstdint>
+#include <string>
+
+using Json = nlohmann::json;
+
+enum class Encoding : uint8_t
+{
+	json,
+	binary
+};
+
+enum class MessageType : uint8_t
+{
+	unknown,
+	connect,
+	error,
+	serverConfig,
+	usersList,
+	addUser,
+	changeUser,
+	removeUser,
+	roomsList,
+	addRoom,
+	removeRoom,
+	changeRoom,
+	createRoom,
+	join,
+	lock,
+	quit,
+	start,
+	ready,
+	placeDigit,
+	move,
+	finish,
+	hint,
+	listRooms,
+	roomsPage,
+	stats,
+	count
+};
+
+enum class Field : uint8_t
+{
+	literal,
+	name,
+	reason,
+	encoding,
+	roomId,
+	roomIds,
+	names,
+	id,
+	ids,
+	host,
+	hosts,
+	guest,
+	guests,
+	locked,
+	locks,
+	lock,
+	change,
+	difficulty,
+	as,
+	puzzle,
+	ready,
+	cell,
+	digit,
+	correct,
+	points,
+	lifes,
+	countdown,
+	winner,
+	technique,
+	cells,
+	epoch,
+	version,
+	cursor,
+	limit,
+	open,
+	unlocked,
+	difficulties,
+	count
+};
+
+const char* toString(Encoding encoding);
+const char* toString(MessageType type);
+const char* toString(Field field);
+Encoding toEncoding(const std::string& encoding);
+MessageType toMessageType(const std::string& type);
+Field toField(const std::string& field);
+
+// the fields a client request can carry, decodeRequest reads them straight from the payload
+// and only builds the json tree in message for a type it does not know
+struct Request
+{
+	MessageType type = MessageType::unknown;
+	std::string name;
+	Encoding encoding = Encoding::json;
+	int roomId = 0;
+	bool lock = false;
+	std::string change;
+	int difficulty = 0;
+	bool ready = true;
+	int cell = -1;
+	int digit = 0;
+	long long epoch = 0;
+	long long version = 0;
+	int cursor = 0;
+	int limit = 0;
+	bool open = false;
+	bool unlocked = false;
+	uint64_t fields = 0;
+	Json message;
+	bool Has(Field field) const;
+};
+static_assert(size_t(Field::count) <= 64, "request fields do not fit the mask");
+
+std::string encodeMessage(const Json& message, Encoding encoding);
+Result decodeMessage(const char* data, size_t size, Encoding encoding, Json& message);
+// also reports the type, interned once here so callers can dispatch on it without comparing names
+Result decodeMessage(const char* data, size_t size, Encoding encoding, Json& message, MessageType& type);
+Result decodeRequest(const char* data, size_t size, Encoding encoding, Request& request);
+// reads only the type of a binary message, json payloads report unknown and have to be decoded
+MessageType peekMessageType(const char* data, size_t size, Encoding encoding);
+
+class MessageWriter
+{
+public:
+	MessageWriter(Encoding encoding, MessageType type);
+	MessageWriter& Integer(Field field, long long value);
+	MessageWriter& Boolean(Field field, bool value);
+	MessageWriter& String(Field field, const std::string& value);
+	MessageWriter& RoomId(Field field, int roomId);
+	MessageWriter& Value(const std::string& key, const Json& value);
+	MessageWriter& BeginArray(Field field, size_t size);
+	MessageWriter& BooleanElement(bool value);
+	MessageWriter& StringElement(const std::string& value);
+	MessageWriter& RoomIdElement(int roomId);
+	MessageWriter& IntegerElement(long long value);
+	MessageWriter& EndArray();
+	const std::string& Finish();
+	std::string Release();
+	Encoding GetEncoding() const;
+private:
+	void BeginField(Field field);
+	void BeginElement();
+	void WriteInteger(long long value);
+private:
+	Encoding encoding;
+	std::string buffer;
+	size_t fieldCountOffset = 0;
+	unsigned int fieldCount = 0;
+	bool firstElement = true;
+	bool finished = false;
+};
@@ -0,0 +1,83 @@
+#include "PuzzleBank.h"
+#include <cstring>
+
+bool PuzzleBank::Open(const std::string& path)
+{
+	if (!file.Open(path) || file.GetSize() < sizeof(PuzzleBankHeader))
+	{
+		file.Close();
+		return false;
+	}
+	const PuzzleBankHeader& header = *reinterpret_cast<const PuzzleBankHeader*>(file.GetData());
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.recordSize != sizeof(PuzzleRecord))
+	{
+		file.Close();
+		return false;
+	}
+	size_t total = 0;
+	for (uint32_t count : header.counts)
+	{
+		total += count;
+	}
+	if (file.GetSize() != sizeof(PuzzleBankHeader) + total * sizeof(PuzzleRecord))
+	{
+		file.Close();
+		return false;
+	}
+	const PuzzleRecord* records = reinterpret_cast<const PuzzleRecord*>(file.GetData() + sizeof(PuzzleBankHeader));
+	for (size_t i = 0; i < size_t(Difficulty::count); ++i)
+	{
+		sections[i] = records;
+		counts[i] = header.counts[i];
+		records += header.counts[i];
+	}
+	return true;
+}
+
+size_t PuzzleBank::GetCount(Difficulty difficulty) const
+{
+	return counts[size_t(difficulty)];
+}
+
+bool PuzzleBank::Get(Difficulty difficulty, size_t index, Puzzle& puzzle) const
+{
+	if (index >= GetCount(difficulty))
+	{
+		return false;
+	}
+	const PuzzleRecord& record = sections[size_t(difficulty)][index];
+	puzzle.difficulty = Difficulty(record.difficulty);
+	return Unpack(record.clues, puzzle.clues) && Unpack(record.solution, puzzle.solution);
+}
+
+void PuzzleBank::Pack(const SudokuBoard& board, uint8_t* packed)
+{
+	std::memset(packed, 0, PuzzleRecord::PACKED_BOARD_SIZE);
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		packed[cell / 2] |= uint8_t(board.Get(cell) << (cell % 2 * 4));
+	}
+}
+
+bool PuzzleBank::Unpack(const uint8_t* packed, SudokuBoard& board)
+{
+	board = SudokuBoard();
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		const int digit = (packed[cell / 2] >> (cell % 2 * 4)) & 0xF;
+		if (digit && !board.Place(cell, digit))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+PuzzleRecord PuzzleBank::ToRecord(const Puzzle& puzzle)
+{
+	PuzzleRecord record;
+	Pack(puzzle.clues, record.clues);
+	Pack(puzzle.solution, record.solution);
+	record.difficulty = uint8_t(puzzle.difficulty);
+	return record;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include "MappedFile.h"
+#include "SudokuGenerator.h"
+#include <cstdint>
+#include <string>
+
+#pragma pack(push, 1)
+struct PuzzleBankHeader
+{
+	char magic[4];
+	uint16_t version;
+	uint16_t recordSize;
+	uint32_t counts[size_t(Difficulty::count)];
+};
+
+struct PuzzleRecord
+{
+	static constexpr const size_t PACKED_BOARD_SIZE = (SudokuBoard::NUMBER_OF_CELLS + 1) / 2;
+	uint8_t clues[PACKED_BOARD_SIZE];
+	uint8_t solution[PACKED_BOARD_SIZE];
+	uint8_t difficulty;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PuzzleBankHeader) == 24, "unexpected puzzle bank header layout");
+static_assert(sizeof(PuzzleRecord) == 83, "unexpected puzzle record layout");
+
+class PuzzleBank
+{
+public:
+	static constexpr const char MAGIC[4] = { 'S', 'D', 'K', 'B' };
+	static constexpr const uint16_t VERSION = 1;
+public:
+	bool Open(const std::string& path);
+	size_t GetCount(Difficulty difficulty) const;
+	bool Get(Difficulty difficulty, size_t index, Puzzle& puzzle) const;
+	static void Pack(const SudokuBoard& board, uint8_t* packed);
+	static bool Unpack(const uint8_t* packed, SudokuBoard& board);
+	static PuzzleRecord ToRecord(const Puzzle& puzzle);
+private:
+	MappedFile file;
+	const PuzzleRecord* sections[size_t(Difficulty::count)] = {};
+	size_t counts[size_t(Difficulty::count)] = {};
+};
@@ -0,0 +1,122 @@
+#include "PuzzlePool.h"
+#include <algorithm>
+#include <random>
+
+PuzzlePool::PuzzlePool(size_t numberOfThreads, size_t queueSize, SolverKind solverKind)
+	: numberOfThreads(numberOfThreads), solverKind(solverKind)
+{
+	for (size_t i = 0; i < size_t(Difficulty::count); ++i)
+	{
+		levels.push_back(std::make_unique<Level>(queueSize));
+	}
+}
+
+void PuzzlePool::Start()
+{
+	if (alive.exchange(true))
+	{
+		return;
+	}
+	startTime = std::chrono::steady_clock::now();
+	std::random_device seeds;
+	for (size_t i = 0; i < numberOfThreads; ++i)
+	{
+		workers.emplace_back(&PuzzlePool::Work, this, seeds());
+	}
+}
+
+void PuzzlePool::Stop()
+{
+	if (!alive.exchange(false))
+	{
+		return;
+	}
+	refillCondition.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+}
+
+bool PuzzlePool::TryPop(Difficulty difficulty, Puzzle& puzzle)
+{
+	Level& level = *levels[size_t(difficulty)];
+	if (!level.queue.TryPop(puzzle))
+	{
+		level.misses.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	level.served.fetch_add(1, std::memory_order_relaxed);
+	refillCondition.notify_one();
+	return true;
+}
+
+PuzzlePool::Statistics PuzzlePool::GetStatistics(Difficulty difficulty) const
+{
+	const Level& level = *levels[size_t(difficulty)];
+	Statistics statistics;
+	statistics.depth = level.queue.GetSize();
+	statistics.capacity = level.queue.GetCapacity();
+	statistics.generated = level.generated.load(std::memory_order_relaxed);
+	statistics.served = level.served.load(std::memory_order_relaxed);
+	statistics.misses = level.misses.load(std::memory_order_relaxed);
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const double seconds = std::chrono::duration<double>(std::min<std::chrono::steady_clock::duration>(now - startTime, RATE_WINDOW)).count();
+	size_t recent = 0;
+	{
+		std::lock_guard<std::mutex> lock(level.refillMutex);
+		recent = size_t(level.refills.end() - std::lower_bound(level.refills.begin(), level.refills.end(), now - RATE_WINDOW));
+	}
+	statistics.refillRate = seconds > 0.0 ? recent / seconds : 0.0;
+	return statistics;
+}
+
+PuzzlePool::~PuzzlePool()
+{
+	Stop();
+}
+
+void PuzzlePool::Work(uint32_t seed)
+{
+	SudokuGenerator generator(seed, solverKind);
+	while (alive.load())
+	{
+		Difficulty difficulty = Difficulty::easy;
+		if (!PickDifficulty(difficulty))
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			refillCondition.wait_for(lock, std::chrono::milliseconds(IDLE_TIMEOUT));
+			continue;
+		}
+		Puzzle puzzle = generator.Generate(difficulty);
+		Level& level = *levels[size_t(puzzle.difficulty)];
+		if (level.queue.TryPush(std::move(puzzle)))
+		{
+			level.generated.fetch_add(1, std::memory_order_relaxed);
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			std::lock_guard<std::mutex> lock(level.refillMutex);
+			while (!level.refills.empty() && level.refills.front() < now - RATE_WINDOW)
+			{
+				level.refills.pop_front();
+			}
+			level.refills.push_back(now);
+		}
+	}
+}
+
+bool PuzzlePool::PickDifficulty(Difficulty& difficulty) const
+{
+	// refill the emptiest queue first so a burst on one level does not starve the others
+	double lowest = 1.0;
+	for (size_t i = 0; i < levels.size(); ++i)
+	{
+		const double fill = double(levels[i]->queue.GetSize()) / levels[i]->queue.GetCapacity();
+		if (fill < lowest)
+		{
+			lowest = fill;
+			difficulty = Difficulty(i);
+		}
+	}
+	return lowest < 1.0;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "BoundedQueue.h"
+#include "SudokuGenerator.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PuzzlePool
+{
+public:
+	struct Statistics
+	{
+		size_t depth;
+		size_t capacity;
+		uint64_t generated;
+		uint64_t served;
+		uint64_t misses;
+		// puzzles per second over the last RATE_WINDOW, a lifetime average would hide a stalled refill
+		double refillRate;
+	};
+public:
+	PuzzlePool(size_t numberOfThreads, size_t queueSize, SolverKind solverKind = SolverKind::bitboard);
+	PuzzlePool(const PuzzlePool&) = delete;
+	PuzzlePool& operator=(const PuzzlePool&) = delete;
+	void Start();
+	void Stop();
+	bool TryPop(Difficulty difficulty, Puzzle& puzzle);
+	Statistics GetStatistics(Difficulty difficulty) const;
+	~PuzzlePool();
+private:
+	void Work(uint32_t seed);
+	bool PickDifficulty(Difficulty& difficulty) const;
+private:
+	struct Level
+	{
+		Level(size_t queueSize)
+			: queue(queueSize)
+		{}
+		BoundedQueue<Puzzle> queue;
+		std::atomic<uint64_t> generated = 0;
+		std::atomic<uint64_t> served = 0;
+		std::atomic<uint64_t> misses = 0;
+		mutable std::mutex refillMutex;
+		std::deque<std::chrono::steady_clock::time_point> refills;
+	};
+	static constexpr const int IDLE_TIMEOUT = 100;
+	static constexpr const std::chrono::seconds RATE_WINDOW = std::chrono::seconds(10);
+	size_t numberOfThreads;
+	SolverKind solverKind;
+	std::vector<std::unique_ptr<Level>> levels;
+	std::atomic<bool> alive = false;
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable refillCondition;
+	std::chrono::steady_clock::time_point startTime;
+};
@@ -1,15 +1,27 @@
 #include "Result.h"
-#include <WinSock2.h>
+#include "SocketHandle.h"
 
 Result errorCodeToResult(int errorCode)
 {
 	switch (errorCode)
 	{
+#ifdef __linux__
+	case ECONNRESET:
+	case EPIPE:
+		return Result::connectionReset;
+	case EWOULDBLOCK:
+#if EAGAIN != EWOULDBLOCK
+	case EAGAIN:
+#endif
+	case EINPROGRESS:
+		return Result::wouldBlock;
+#else
 	case WSAECONNRESET:
 		return Result::connectionReset;
 	case WSAEWOULDBLOCK:
 		return Result::wouldBlock;
+#endif
 	default:
 		return Result::genericError;
 	}
-}
\ No newline at end of file
+}
@@ -5,5 +5,131 @@ int Room::newRoomId = 1;
 void Room::ChangeGuestToHost()
 {
 	host = guest;
-	guest.name = "";
+	guest = Player();
+}
+
+Player* Room::FindPlayer(const std::string& name)
+{
+	if (host.name == name)
+	{
+		return &host;
+	}
+	if (guest && guest.name == name)
+	{
+		return &guest;
+	}
+	return nullptr;
+}
+
+bool Room::SetReady(Player& player, bool ready)
+{
+	if (state == MatchState::countdown || state == MatchState::playing)
+	{
+		return false;
+	}
+	player.ready = ready;
+	state = host.ready && guest && guest.ready ? MatchState::ready : MatchState::waiting;
+	return true;
+}
+
+void Room::StartCountdown(Puzzle&& puzzle, Clock::time_point now)
+{
+	this->puzzle = std::move(puzzle);
+	for (Player* player : { &host, &guest })
+	{
+		player->board.Load(this->puzzle.clues.ToString());
+		player->points = 0;
+		player->lifes = START_LIFES;
+		player->ready = false;
+	}
+	winner.clear();
+	++match;
+	playingAt = now + COUNTDOWN;
+	state = MatchState::countdown;
+}
+
+MoveResult Room::PlaceDigit(Player& player, int cell, int digit, Clock::time_point now)
+{
+	Update(now);
+	if (state != MatchState::playing || cell < 0 || cell >= LiveBoard::NUMBER_OF_CELLS ||
+		digit < 1 || digit > LiveBoard::SIZE || player.board.Get(cell))
+	{
+		return MoveResult::rejected;
+	}
+	if (puzzle.solution.Get(cell) != digit)
+	{
+		if (--player.lifes == 0)
+		{
+			Finish(&player == &host ? guest.name : host.name);
+		}
+		return MoveResult::wrong;
+	}
+	player.board.Place(cell, digit);
+	player.points += POINTS_PER_DIGIT;
+	if (player.board.IsSolved())
+	{
+		Finish(player.name);
+	}
+	return MoveResult::correct;
+}
+
+HintResult Room::CheckHint(Player& player, Clock::time_point now)
+{
+	Update(now);
+	if (state != MatchState::playing)
+	{
+		return HintResult::rejected;
+	}
+	// hints are paid in points while they last, then in lifes, but never with the last life
+	if (player.points < HINT_COST && player.lifes <= 1)
+	{
+		return HintResult::unaffordable;
+	}
+	return HintResult::found;
+}
+
+HintResult Room::ChargeHint(Player& player, unsigned long match, const Deduction* hint, Clock::time_point now)
+{
+	// the board only gains correct digits while the search runs, so a hint stays valid until its
+	// cell is filled or a new match starts
+	const HintResult result = CheckHint(player, now);
+	if (result != HintResult::found || match != this->match || (hint && player.board.Get(hint->cell)))
+	{
+		return result == HintResult::found ? HintResult::rejected : result;
+	}
+	if (!hint)
+	{
+		return HintResult::notFound;
+	}
+	if (player.points >= HINT_COST)
+	{
+		player.points -= HINT_COST;
+	}
+	else
+	{
+		--player.lifes;
+	}
+	return HintResult::found;
+}
+
+void Room::EndMatch()
+{
+	host.ready = false;
+	guest.ready = false;
+	winner.clear();
+	state = MatchState::waiting;
+}
+
+void Room::Update(Clock::time_point now)
+{
+	if (state == MatchState::countdown && now >= playingAt)
+	{
+		state = MatchState::playing;
+	}
+}
+
+void Room::Finish(const std::string& winner)
+{
+	this->winner = winner;
+	state = MatchState::finished;
 }
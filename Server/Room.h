@@ -1,12 +1,41 @@
 #pragma once
 #include "Player.h"
-#include "ServerSocket.h"
+#include "Connection.h"
+#include "HintEngine.h"
+#include "SudokuGenerator.h"
+#include <chrono>
+
+enum class MatchState : uint8_t
+{
+	waiting,
+	ready,
+	countdown,
+	playing,
+	finished
+};
+
+enum class MoveResult : uint8_t
+{
+	rejected,
+	correct,
+	wrong
+};
+
+enum class HintResult : uint8_t
+{
+	rejected,
+	unaffordable,
+	notFound,
+	found
+};
 
 class Room
 {
 public:
-	Room(const std::string& hostName, ServerSocket* socket)
-		: id(newRoomId++), host(hostName, socket)
+	using Clock = std::chrono::steady_clock;
+public:
+	Room(const std::string& hostName, Connection* connection)
+		: id(newRoomId++), host(hostName, connection)
 	{}
 	int GetId() const
 	{
@@ -28,10 +57,10 @@ public:
 	{
 		return difficulty;
 	}
-	void SetGuest(const std::string& name, ServerSocket* socket)
+	void SetGuest(const std::string& name, Connection* connection)
 	{
 		guest.name = name;
-		guest.socket = socket;
+		guest.connection = connection;
 	}
 	void ChangeGuestToHost();
 	void SetLock(bool locked)
@@ -42,6 +71,38 @@ public:
 	{
 		this->difficulty = difficulty;
 	}
+	MatchState GetState() const
+	{
+		return state;
+	}
+	const Puzzle& GetPuzzle() const
+	{
+		return puzzle;
+	}
+	const std::string& GetWinner() const
+	{
+		return winner;
+	}
+	Player* FindPlayer(const std::string& name);
+	bool SetReady(Player& player, bool ready);
+	void StartCountdown(Puzzle&& puzzle, Clock::time_point now);
+	MoveResult PlaceDigit(Player& player, int cell, int digit, Clock::time_point now);
+	// found when the player may pay for a hint, the search itself runs outside the lobby lock
+	HintResult CheckHint(Player& player, Clock::time_point now);
+	HintResult ChargeHint(Player& player, unsigned long match, const Deduction* hint, Clock::time_point now);
+	unsigned long GetMatch() const
+	{
+		return match;
+	}
+	void EndMatch();
+private:
+	void Update(Clock::time_point now);
+	void Finish(const std::string& winner);
+public:
+	static constexpr const std::chrono::milliseconds COUNTDOWN = std::chrono::milliseconds(3000);
+	static constexpr const unsigned long START_LIFES = 3;
+	static constexpr const unsigned long POINTS_PER_DIGIT = 10;
+	static constexpr const unsigned long HINT_COST = 15;
 private:
 	static int newRoomId;
 	int id;
@@ -49,5 +110,11 @@ private:
 	Player guest;
 	bool locked = false;
 	int difficulty = 0;
+	MatchState state = MatchState::waiting;
+	Puzzle puzzle;
+	Clock::time_point playingAt;
+	std::string winner;
+	// counts the matches started in the room, a hint searched for an earlier one is stale
+	unsigned long match = 0;
 };
 
@@ -0,0 +1,99 @@
+#include "RoomIndex.h"
+#include "Room.h"
+#include <algorithm>
+
+bool RoomFilter::Matches(const Room& room) const
+{
+	return (!open || !room.GetGuest()) && (!unlocked || !room.IsLocked()) && (difficulty < 0 || room.GetDifficulty() == difficulty);
+}
+
+bool RoomPage::Contains(int roomId) const
+{
+	return std::binary_search(ids.begin(), ids.end(), roomId);
+}
+
+bool RoomPage::Accepts(const Room& room) const
+{
+	// room ids only grow, appending a new room keeps the page ordered
+	return tail && ids.size() < limit && filter.Matches(room);
+}
+
+void RoomIndex::Insert(const Room& room)
+{
+	const uint8_t key = KeyOf(room);
+	buckets[key].insert(room.GetId());
+	keys.Insert(room.GetId(), key);
+}
+
+void RoomIndex::Update(const Room& room)
+{
+	uint8_t* key = keys.Find(room.GetId());
+	if (!key)
+	{
+		return;
+	}
+	const uint8_t newKey = KeyOf(room);
+	if (newKey != *key)
+	{
+		buckets[*key].erase(room.GetId());
+		buckets[newKey].insert(room.GetId());
+		*key = newKey;
+	}
+}
+
+void RoomIndex::Erase(int roomId)
+{
+	if (const uint8_t* key = keys.Find(roomId))
+	{
+		buckets[*key].erase(roomId);
+		keys.Erase(roomId);
+	}
+}
+
+int RoomIndex::Page(int cursor, const RoomFilter& filter, size_t limit, std::vector<int>& ids) const
+{
+	// every bucket is ordered by id, merging the matching ones visits only the rooms of the page
+	std::set<int>::const_iterator heads[NUMBER_OF_BUCKETS];
+	std::set<int>::const_iterator ends[NUMBER_OF_BUCKETS];
+	size_t count = 0;
+	for (uint8_t key = 0; key < NUMBER_OF_BUCKETS; ++key)
+	{
+		if (Matches(key, filter) && !buckets[key].empty())
+		{
+			heads[count] = buckets[key].upper_bound(cursor);
+			ends[count] = buckets[key].end();
+			++count;
+		}
+	}
+	ids.clear();
+	for (;;)
+	{
+		size_t next = count;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (heads[i] != ends[i] && (next == count || *heads[i] < *heads[next]))
+			{
+				next = i;
+			}
+		}
+		if (next == count)
+		{
+			return 0;
+		}
+		if (ids.size() == limit)
+		{
+			return ids.empty() ? cursor : ids.back();
+		}
+		ids.push_back(*heads[next]++);
+	}
+}
+
+uint8_t RoomIndex::KeyOf(const Room& room)
+{
+	return uint8_t((room.GetGuest() ? 1 : 0) | (room.IsLocked() ? 2 : 0) | (int(toDifficulty(room.GetDifficulty())) << 2));
+}
+
+bool RoomIndex::Matches(uint8_t key, const RoomFilter& filter)
+{
+	return (!filter.open || !(key & 1)) && (!filter.unlocked || !(key & 2)) && (filter.difficulty < 0 || (key >> 2) == filter.difficulty);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "HashIndex.h"
+#include "SudokuGrader.h"
+#include <cstdint>
+#include <set>
+#include <vector>
+
+class Room;
+
+struct RoomFilter
+{
+	bool open = false;
+	bool unlocked = false;
+	int difficulty = -1;
+	bool Matches(const Room& room) const;
+};
+
+// the rooms a paging client looks at, it is only sent the changes of these rooms
+struct RoomPage
+{
+	bool paged = false;
+	RoomFilter filter;
+	int cursor = 0;
+	size_t limit = 0;
+	// the page reaches the newest room, so matching rooms created later still fit in
+	bool tail = false;
+	std::vector<int> ids;
+	bool Contains(int roomId) const;
+	bool Accepts(const Room& room) const;
+};
+
+// room ids bucketed by everything a filter can ask for, a page only visits matching rooms
+class RoomIndex
+{
+public:
+	void Insert(const Room& room);
+	void Update(const Room& room);
+	void Erase(int roomId);
+	// fills ids with up to limit matching rooms after cursor, returns the cursor of the next page or 0
+	int Page(int cursor, const RoomFilter& filter, size_t limit, std::vector<int>& ids) const;
+private:
+	static uint8_t KeyOf(const Room& room);
+	static bool Matches(uint8_t key, const RoomFilter& filter);
+private:
+	// guest x lock x difficulty
+	static constexpr const size_t NUMBER_OF_BUCKETS = 4 * size_t(Difficulty::count);
+	std::set<int> buckets[NUMBER_OF_BUCKETS];
+	HashIndex<int, uint8_t> keys;
+};
@@ -2,8 +2,29 @@
 #include "Logger.h"
 #include "NetworkException.h"
 #include "IOMode.h"
+#include "SudokuTransform.h"
+#include <algorithm>
 #include <fstream>
 
+static uint64_t makeCoalesceKey(MessageType type, const std::string& change, const std::string& subject)
+{
+	return std::hash<std::string>{}(std::string(toString(type)) + '/' + change + '/' + subject) | 1u;
+}
+
+// requests are dispatched by their interned type, types a client may not send stay empty
+const std::array<Server::RequestHandler, size_t(MessageType::count)> Server::REQUEST_HANDLERS = [] {
+	std::array<RequestHandler, size_t(MessageType::count)> handlers = {};
+	handlers[size_t(MessageType::createRoom)] = &Server::HandleCreateRoom;
+	handlers[size_t(MessageType::join)] = &Server::HandleJoin;
+	handlers[size_t(MessageType::lock)] = &Server::HandleLock;
+	handlers[size_t(MessageType::quit)] = &Server::HandleQuit;
+	handlers[size_t(MessageType::changeRoom)] = &Server::HandleChangeRoom;
+	handlers[size_t(MessageType::placeDigit)] = &Server::HandlePlaceDigit;
+	handlers[size_t(MessageType::listRooms)] = &Server::HandleListRooms;
+	handlers[size_t(MessageType::stats)] = &Server::HandleStats;
+	return handlers;
+}();
+
 Server::Server(const std::string& configPath)
 {
 	std::ifstream in(configPath);
@@ -14,223 +35,371 @@ Server::Server(const std::string& configPath)
 void Server::Start()
 {
 	socket.create(TransmissionType::unicast, serverConfig["TIMEOUT"]);
+#ifdef __linux__
+	// a restarted server must not wait for the connections it drained to leave TIME_WAIT
+	socket.setSocketOption(SocketOption::SO_ReuseAddress, TRUE);
+#endif
 	socket.bind(serverEndpoint);
-	serverThread = std::make_unique<std::thread>(&Server::Listen, this, 5);
+	if (socket.listen(serverConfig.value("BACKLOG", 128)) != Result::success)
+	{
+		throw NETWORK_EXCEPTION(lastSocketError());
+	}
+	const std::string puzzleBankPath = serverConfig.value("PUZZLE_BANK", "");
+	if (!puzzleBankPath.empty() && !puzzleBank.Open(puzzleBankPath))
+	{
+		LOG << "could not load puzzle bank " + puzzleBankPath + ", puzzles will be generated on demand\n";
+	}
+	maxNumberOfUsers = serverConfig.value("MAX_NUMBER_OF_USERS", 10000);
+	maxNumberOfRooms = serverConfig.value("MAX_NUMBER_OF_ROOMS", 5000);
+	maxRoomsPage = std::max<size_t>(1, serverConfig.value("MAX_ROOMS_PAGE", 100));
+	randomTransforms = serverConfig.value("RANDOM_TRANSFORMS", true);
+	const std::string solverName = serverConfig.value("SOLVER", "bitboard");
+	if (!toSolverKind(solverName, solverKind))
+	{
+		LOG << "unknown solver " + solverName + ", using " + toString(solverKind) + "\n";
+	}
+	hintBudget = std::chrono::milliseconds(serverConfig.value("HINT_BUDGET_MS", 20));
+	lobbyLog.SetCapacity(serverConfig.value("LOBBY_LOG_SIZE", 1024));
+	drainTimeout = std::chrono::milliseconds(serverConfig.value("DRAIN_TIMEOUT_MS", 2000));
+	const size_t generatorThreads = serverConfig.value("GENERATOR_THREADS", 1);
+	if (generatorThreads > 0)
+	{
+		puzzlePool = std::make_unique<PuzzlePool>(generatorThreads, serverConfig.value("READY_PUZZLES", 16), solverKind);
+		puzzlePool->Start();
+	}
+	ioCore = std::make_unique<IOCore>(serverConfig.value("WORKER_THREADS", 2),
+		serverConfig.value("OUTBOUND_QUEUE_SIZE", 64),
+		toOverflowPolicy(serverConfig.value("OUTBOUND_OVERFLOW", "coalesce")),
+		[this](Connection& connection, const Request& request) { OnMessage(connection, request); },
+		[this](Connection& connection) { OnDisconnect(connection); });
+	ioCore->Start();
+	ioCore->Listen(std::move(socket));
 	LOG << "server on " + serverEndpoint.toString() + " successfuly started\n";
 }
 
-
-Server::~Server()
+void Server::Stop()
 {
-	alive.store(false);
-	if (serverThread)
+	// main stops the server and the destructor stops it again, only the first call drains
+	if (stopped)
+	{
+		return;
+	}
+	stopped = true;
+	if (ioCore)
+	{
+		ioCore->Drain(drainTimeout);
+	}
+	if (puzzlePool)
 	{
-		serverThread->join();
-		serverThread.reset();
+		puzzlePool->Stop();
 	}
 }
 
-void Server::Listen(int backlog)
+Server::~Server()
 {
-	while (alive.load())
-	{
-		if (socket.listen(backlog) == Result::success)
-		{
-			ServerSocket respondingSocket;
-			if (socket.accept(respondingSocket) == Result::success)
-			{
-				LOG << "Added client on " + respondingSocket.toString() << '\n';
-				std::thread clientThread(&Server::StartConnection, this, std::move(respondingSocket));
-				clientThread.detach();
-			}
-		}
-	}
+	Stop();
 }
 
-void Server::StartConnection(ServerSocket&& socket)
+void Server::OnMessage(Connection& connection, const Request& request)
 {
-	std::string name;
-	if (socket.setIOMode(IOMode::fionbio, 0ul) != Result::success)
+	// a hint search or a puzzle generated on demand may take milliseconds, these requests
+	// only hold the lock before and after the work
+	if (request.type == MessageType::hint)
 	{
-		int errorCode = WSAGetLastError();
-		throw NETWORK_EXCEPTION(errorCode);
+		TakeHint(connection);
+		return;
 	}
-	Json data;
-	Result result = Result::success;
-	if (socket.recieveJson(data) == Result::success)
+	if (request.type == MessageType::ready)
 	{
-		if (data["type"] != "connect")
-		{
-			Json respond;
-			respond["type"] = "error";
-			respond["reason"] = "not connected";
-			socket.sendJson(respond);
-			return;
-		}
-		name = data["name"];
-		if (HandleConnectionRequest(name, std::move(socket)) != Result::success)
-		{
-			return;
-		}
-		WaitForMessages(name);
+		SetReady(connection, request.ready);
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	if (connection.user)
+	{
+		HandleMessage(*connection.user, request);
+		return;
+	}
+	if (request.type != MessageType::connect)
+	{
+		Json respond;
+		respond["type"] = "error";
+		respond["reason"] = "not connected";
+		connection.Send(respond);
+		connection.Close();
+		return;
+	}
+	if (HandleConnectionRequest(request, connection) != Result::success)
+	{
+		connection.Close();
 	}
 }
 
-void Server::WaitForMessages(const std::string& name)
+void Server::OnDisconnect(Connection& connection)
 {
-	mutex.lock();
-	User& user = *std::find_if(users.begin(), users.end(), [&name](const User& user) {return user.name == name; });
-	mutex.unlock();
-	if (user.socket.setSocketOption(SocketOption::SO_RecieveTimeout, 0ul) != Result::success)
+	std::lock_guard<std::mutex> lock(mutex);
+	if (connection.user)
 	{
-		int errorCode = WSAGetLastError();
-		throw NETWORK_EXCEPTION(errorCode);
+		RemoveUser(*connection.user);
+		connection.user = nullptr;
 	}
-	Json data;
-	Result result = Result::success;
-	while (result == Result::success && alive.load())
-	{
-		if ((result = user.socket.recieveJson(data)) == Result::success)
-		{
-			result = HandleMessage(user, data);
-		}
-	}
-	RemoveUser(user);
 }
 
 void Server::SendUsers(User& user)
 {
-	std::vector<std::string> roomIds;
-	std::vector<std::string> names;
-	roomIds.reserve(users.size());
-	names.reserve(users.size());
+	user.connection->Send(WriteUsers(user));
+}
+
+SharedFrame Server::WriteUsers(const User& user)
+{
+	MessageWriter message(user.connection->GetEncoding(), MessageType::usersList);
+	message.BeginArray(Field::roomIds, users.size());
 	for (const auto& u : users)
 	{
-		roomIds.push_back(std::to_string(u.room ? u.room->GetId() : 0));
-		names.push_back(u.name);
+		message.RoomIdElement(u.room ? u.room->GetId() : 0);
 	}
-
-	Json message;
-	message["type"] = "usersList";
-	message["roomIds"] = roomIds;
-	message["names"] = names;
-	user.socket.sendJson(message);
+	message.EndArray();
+	message.BeginArray(Field::names, users.size());
+	for (const auto& u : users)
+	{
+		message.StringElement(u.name);
+	}
+	message.EndArray();
+	message.Integer(Field::version, (long long)lobbyLog.GetVersion());
+	return std::make_shared<const std::string>(message.Release());
 }
 
 void Server::AddUser(User && user)
 {
 	users.emplace_front(std::move(user));
+	usersByName.Insert(users.front().name, users.begin());
 	BroadcastAddUser(users.front());
 }
 
 void Server::SendRooms(User & user)
 {
-	std::vector<std::string> ids;
-	std::vector<std::string> hosts;
-	std::vector<std::string> guests;
-	std::vector<bool> locks;
-	ids.reserve(users.size());
-	hosts.reserve(users.size());
-	guests.reserve(users.size());
-	locks.reserve(users.size());
+	user.connection->Send(WriteRooms(user));
+}
+
+SharedFrame Server::WriteRooms(User& user)
+{
+	if (user.page.paged)
+	{
+		return WriteRoomsPage(user);
+	}
+	MessageWriter message(user.connection->GetEncoding(), MessageType::roomsList);
+	message.BeginArray(Field::ids, rooms.size());
 	for (const auto& r : rooms)
 	{
-		ids.push_back(std::to_string(r.GetId()));
-		hosts.push_back(r.GetHost().name);
-		guests.push_back(r.GetGuest().name);
-		locks.push_back(r.IsLocked());
+		message.RoomIdElement(r.GetId());
+	}
+	message.EndArray();
+	message.BeginArray(Field::hosts, rooms.size());
+	for (const auto& r : rooms)
+	{
+		message.StringElement(r.GetHost().name);
+	}
+	message.EndArray();
+	message.BeginArray(Field::guests, rooms.size());
+	for (const auto& r : rooms)
+	{
+		message.StringElement(r.GetGuest().name);
+	}
+	message.EndArray();
+	message.BeginArray(Field::locks, rooms.size());
+	for (const auto& r : rooms)
+	{
+		message.BooleanElement(r.IsLocked());
+	}
+	message.EndArray();
+	message.Integer(Field::version, (long long)lobbyLog.GetVersion());
+	return std::make_shared<const std::string>(message.Release());
+}
+
+void Server::SendRoomsPage(User& user)
+{
+	user.connection->Send(WriteRoomsPage(user));
+}
+
+SharedFrame Server::WriteRoomsPage(User& user)
+{
+	RoomPage& page = user.page;
+	const int next = roomIndex.Page(page.cursor, page.filter, page.limit, page.ids);
+	page.tail = next == 0;
+	std::vector<const Room*> pageRooms;
+	pageRooms.reserve(page.ids.size());
+	for (int id : page.ids)
+	{
+		pageRooms.push_back(FindRoom(id));
+	}
+	MessageWriter message(user.connection->GetEncoding(), MessageType::roomsPage);
+	message.BeginArray(Field::ids, pageRooms.size());
+	for (const Room* r : pageRooms)
+	{
+		message.RoomIdElement(r->GetId());
+	}
+	message.EndArray();
+	message.BeginArray(Field::hosts, pageRooms.size());
+	for (const Room* r : pageRooms)
+	{
+		message.StringElement(r->GetHost().name);
+	}
+	message.EndArray();
+	message.BeginArray(Field::guests, pageRooms.size());
+	for (const Room* r : pageRooms)
+	{
+		message.StringElement(r->GetGuest().name);
+	}
+	message.EndArray();
+	message.BeginArray(Field::locks, pageRooms.size());
+	for (const Room* r : pageRooms)
+	{
+		message.BooleanElement(r->IsLocked());
+	}
+	message.EndArray();
+	message.BeginArray(Field::difficulties, pageRooms.size());
+	for (const Room* r : pageRooms)
+	{
+		message.IntegerElement(r->GetDifficulty());
+	}
+	message.EndArray();
+	message.RoomId(Field::cursor, next)
+		.Integer(Field::version, (long long)lobbyLog.GetVersion());
+	return std::make_shared<const std::string>(message.Release());
+}
+
+void Server::SetRoomPage(User& user, const Request& request)
+{
+	RoomPage& page = user.page;
+	page.paged = true;
+	page.filter.open = request.open;
+	page.filter.unlocked = request.unlocked;
+	page.filter.difficulty = request.Has(Field::difficulty) ? int(toDifficulty(request.difficulty)) : -1;
+	page.cursor = std::max(request.cursor, 0);
+	// a request without a limit keeps the page size the client asked for before
+	if (request.Has(Field::limit) && request.limit > 0)
+	{
+		page.limit = std::min(size_t(request.limit), maxRoomsPage);
+	}
+	else if (page.limit == 0)
+	{
+		page.limit = maxRoomsPage;
 	}
+}
 
-	Json message;
-	message["type"] = "roomsList";
-	message["ids"] = ids;
-	message["hosts"] = hosts;
-	message["guests"] = guests;
-	message["locks"] = locks;
-	user.socket.sendJson(message);
+void Server::SyncLobby(User& user, const Request& request)
+{
+	// a client that connects with a page size never gets the whole rooms list
+	if (request.Has(Field::limit))
+	{
+		SetRoomPage(user, request);
+	}
+	const bool paged = user.page.paged;
+	// a client that still knows this lobby is sent the changes it missed, unless the lists are shorter
+	if (request.Has(Field::epoch) && request.Has(Field::version) && request.epoch == lobbyEpoch && request.version >= 0)
+	{
+		const long long missed = lobbyLog.CountSince(uint64_t(request.version));
+		if (missed >= 0 && size_t(missed) <= users.size() + rooms.size())
+		{
+			lobbyLog.ReplaySince(uint64_t(request.version), user.connection->GetEncoding(), [&user, paged](const SharedFrame& frame, int roomId) {
+				// a paging client gets its rooms as a fresh page instead
+				if (!paged || roomId == 0)
+				{
+					user.connection->Send(frame);
+				}
+			});
+			if (paged)
+			{
+				SendRoomsPage(user);
+			}
+			return;
+		}
+	}
+	SendUsers(user);
+	SendRooms(user);
 }
 
 void Server::CreateRoom(User & user)
 {
-	Room room(user.name, &user.socket);
-	BroadcastAddRoom(room);
-	rooms.emplace_back(std::move(room));
+	rooms.emplace_back(user.name, user.connection);
+	roomsById.Insert(rooms.back().GetId(), std::prev(rooms.end()));
+	roomIndex.Insert(rooms.back());
+	// the creator follows its own room even when the room does not fit its page
 	user.room = &rooms.back();
-	Json message;
-	message["type"] = "changeUser";
-	message["change"] = "roomId";
-	message["name"] = user.name;
-	message["roomId"] = std::to_string(user.room->GetId());
-	BroadcastMessage(message);
-
-	message = Json{};
-	message["type"] = "join";
-	message["roomId"] = room.GetId();
-	message["host"] = user.name;
-	message["guest"] = "";
-	message["as"] = "host";
-	message["locked"] = room.IsLocked();
-	message["difficulty"] = room.GetDifficulty();
-	user.socket.sendJson(message);
+	BroadcastAddRoom(rooms.back());
+	BroadcastMessage(MessageType::changeUser, [&user](MessageWriter& message) {
+		message.String(Field::change, "roomId")
+			.String(Field::name, user.name)
+			.RoomId(Field::roomId, user.room->GetId());
+	}, makeCoalesceKey(MessageType::changeUser, "roomId", user.name));
+
+	MessageWriter message(user.connection->GetEncoding(), MessageType::join);
+	message.Integer(Field::roomId, user.room->GetId())
+		.String(Field::host, user.name)
+		.String(Field::guest, "")
+		.String(Field::as, "host")
+		.Boolean(Field::locked, user.room->IsLocked())
+		.Integer(Field::difficulty, user.room->GetDifficulty());
+	user.connection->Send(message);
 }
 
 void Server::RemoveRoom(Room & room)
 {
-	BroadcastRemoveRoom(room);
-	rooms.erase(FindRoom(room.GetId()));
+	// the lobby state has to match the version of the change when a lagging client is resynced
+	const int roomId = room.GetId();
+	rooms.erase(*roomsById.Find(roomId));
+	roomsById.Erase(roomId);
+	roomIndex.Erase(roomId);
+	BroadcastRemoveRoom(roomId);
 }
 
 void Server::JoinRoom(User& user, int roomId)
 {
-	auto it = FindRoom(roomId);
-	if (it != rooms.end())
+	if (Room* found = FindRoom(roomId))
 	{
-		Room& room = *it;
+		Room& room = *found;
 		if (!room.GetGuest())
 		{
-			room.SetGuest(user.name, &user.socket);
+			room.SetGuest(user.name, user.connection);
+			roomIndex.Update(room);
 			user.room = &room;
-			Json message;
-			message["type"] = "join";
-			message["roomId"] = roomId;
-			message["as"] = "guest";
-			message["host"] = room.GetHost().name;
-			message["guest"] = user.name;
-			message["locked"] = room.IsLocked();
-			message["difficulty"] = room.GetDifficulty();
-			user.socket.sendJson(message);
-			
-			message = Json{};
-			message["type"] = "changeRoom";
-			message["change"] = "guest";
-			message["roomId"] = std::to_string(roomId);
-			message["guest"] = user.name;
-			BroadcastMessage(message);
-
-			message = Json{};
-			message["type"] = "changeUser";
-			message["change"] = "roomId";
-			message["name"] = user.name;
-			message["roomId"] = std::to_string(roomId);
-			BroadcastMessage(message);
+			MessageWriter message(user.connection->GetEncoding(), MessageType::join);
+			message.Integer(Field::roomId, roomId)
+				.String(Field::as, "guest")
+				.String(Field::host, room.GetHost().name)
+				.String(Field::guest, user.name)
+				.Boolean(Field::locked, room.IsLocked())
+				.Integer(Field::difficulty, room.GetDifficulty());
+			user.connection->Send(message);
+
+			BroadcastMessage(MessageType::changeRoom, [&user, roomId](MessageWriter& message) {
+				message.String(Field::change, "guest")
+					.RoomId(Field::roomId, roomId)
+					.String(Field::guest, user.name);
+			}, makeCoalesceKey(MessageType::changeRoom, "guest", std::to_string(roomId)), roomId);
+
+			BroadcastMessage(MessageType::changeUser, [&user, roomId](MessageWriter& message) {
+				message.String(Field::change, "roomId")
+					.String(Field::name, user.name)
+					.RoomId(Field::roomId, roomId);
+			}, makeCoalesceKey(MessageType::changeUser, "roomId", user.name));
 		}
 	}
 }
 
 void Server::LockRoom(int roomId, bool locked)
 {
-	auto it = FindRoom(roomId);
-	if (it != rooms.end())
+	if (Room* found = FindRoom(roomId))
 	{
-		Room& room = *it;
+		Room& room = *found;
 		room.SetLock(locked);
+		roomIndex.Update(room);
 
-		Json message;
-		message["type"] = "changeRoom";
-		message["change"] = "lock";
-		message["roomId"] = std::to_string(roomId);
-		message["lock"] = locked;
-		BroadcastMessage(message);
+		BroadcastMessage(MessageType::changeRoom, [roomId, locked](MessageWriter& message) {
+			message.String(Field::change, "lock")
+				.RoomId(Field::roomId, roomId)
+				.Boolean(Field::lock, locked);
+		}, makeCoalesceKey(MessageType::changeRoom, "lock", std::to_string(roomId)), roomId);
 	}
 }
 
@@ -238,166 +407,413 @@ void Server::QuitRoom(User & user)
 {
 	if (user.room)
 	{
-		if (user.room->GetGuest())
+		LeaveRoom(user);
+		BroadcastMessage(MessageType::changeUser, [&user](MessageWriter& message) {
+			message.String(Field::change, "roomId")
+				.String(Field::name, user.name)
+				.RoomId(Field::roomId, 0);
+		}, makeCoalesceKey(MessageType::changeUser, "roomId", user.name));
+
+		MessageWriter message(user.connection->GetEncoding(), MessageType::quit);
+		user.connection->Send(message);
+	}
+}
+
+void Server::LeaveRoom(User& user)
+{
+	Room& room = *user.room;
+	user.room = nullptr;
+	const bool forfeited = room.GetState() == MatchState::countdown || room.GetState() == MatchState::playing;
+	room.EndMatch();
+	if (room.GetGuest())
+	{
+		if (room.GetGuest().name == user.name)
 		{
-			Json message;
-			if (user.room->GetGuest().name == user.name)
-			{
-				message["type"] = "changeRoom";
-				message["roomId"] = std::to_string(user.room->GetId());
-				message["change"] = "guest";
-				message["guest"] = "";
-				user.room->SetGuest("", nullptr);
-			}
-			else
-			{
-				message["type"] = "changeRoom";
-				message["roomId"] = std::to_string(user.room->GetId());
-				message["change"] = "host";
-				message["host"] = user.room->GetGuest().name;
-				user.room->ChangeGuestToHost();
-			}
-			BroadcastMessage(message);
+			room.SetGuest("", nullptr);
+			roomIndex.Update(room);
+			BroadcastMessage(MessageType::changeRoom, [&room](MessageWriter& message) {
+				message.RoomId(Field::roomId, room.GetId())
+					.String(Field::change, "guest")
+					.String(Field::guest, "");
+			}, makeCoalesceKey(MessageType::changeRoom, "guest", std::to_string(room.GetId())), room.GetId());
 		}
 		else
 		{
-			RemoveRoom(*user.room);
+			room.ChangeGuestToHost();
+			roomIndex.Update(room);
+			BroadcastMessage(MessageType::changeRoom, [&room](MessageWriter& message) {
+				message.RoomId(Field::roomId, room.GetId())
+					.String(Field::change, "host")
+					.String(Field::host, room.GetHost().name);
+			}, makeCoalesceKey(MessageType::changeRoom, "host", std::to_string(room.GetId())), room.GetId());
 		}
-		user.room = nullptr;
-		Json message;
-		message["type"] = "changeUser";
-		message["change"] = "roomId";
-		message["name"] = user.name;
-		message["roomId"] = "0";
-		BroadcastMessage(message);
-
-		message = Json{};
-		message["type"] = "quit";
-		user.socket.sendJson(message);
+		if (forfeited)
+		{
+			SendToPlayers(room, MessageType::finish, [&room](MessageWriter& message, const Player&) {
+				message.String(Field::winner, room.GetHost().name);
+			});
+		}
+	}
+	else
+	{
+		RemoveRoom(room);
 	}
 }
 
 void Server::ChangeRoomDifficulty(Room & room, int difficulty)
 {
+	difficulty = int(toDifficulty(difficulty));
 	room.SetDifficulty(difficulty);
-	Json message;
-	message["type"] = "changeRoom";
-	message["change"] = "difficulty";
-	message["difficulty"] = difficulty;
-	room.GetHost().socket->sendJson(message);
-	if (room.GetGuest())
+	roomIndex.Update(room);
+	// the difficulty is part of what a page can filter on, so it is a lobby change like the others
+	BroadcastMessage(MessageType::changeRoom, [&room, difficulty](MessageWriter& message) {
+		message.String(Field::change, "difficulty")
+			.RoomId(Field::roomId, room.GetId())
+			.Integer(Field::difficulty, difficulty);
+	}, makeCoalesceKey(MessageType::changeRoom, "difficulty", std::to_string(room.GetId())), room.GetId());
+}
+
+void Server::SetReady(Connection& connection, bool ready)
+{
+	int roomId = 0;
+	Difficulty difficulty = Difficulty::easy;
+	uint32_t seed = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		User* user = connection.user;
+		Player* player = user && user->room ? user->room->FindPlayer(user->name) : nullptr;
+		if (!player)
+		{
+			return;
+		}
+		Room& room = *user->room;
+		if (!room.SetReady(*player, ready))
+		{
+			return;
+		}
+		const std::string as = player == &room.GetHost() ? "host" : "guest";
+		SendToPlayers(room, MessageType::ready, [&as, ready](MessageWriter& message, const Player&) {
+			message.String(Field::as, as)
+				.Boolean(Field::ready, ready);
+		});
+		if (room.GetState() != MatchState::ready)
+		{
+			return;
+		}
+		difficulty = toDifficulty(room.GetDifficulty());
+		Puzzle puzzle;
+		if (TakePuzzle(difficulty, puzzle))
+		{
+			StartMatch(room, std::move(puzzle));
+			return;
+		}
+		if (puzzlePool)
+		{
+			const PuzzlePool::Statistics statistics = puzzlePool->GetStatistics(difficulty);
+			LOG << std::string("no ready ") + toString(difficulty) + " puzzle (misses: " + std::to_string(statistics.misses) +
+				", refill rate: " + std::to_string(statistics.refillRate) + "/s), generating on demand\n";
+		}
+		roomId = room.GetId();
+		seed = uint32_t(random());
+	}
+	for (;;)
 	{
-		room.GetGuest().socket->sendJson(message);
+		Puzzle puzzle = SudokuGenerator(seed, solverKind).Generate(difficulty);
+
+		// a player may have left or taken the ready back in the meantime
+		std::lock_guard<std::mutex> lock(mutex);
+		Room* room = FindRoom(roomId);
+		if (!room || room->GetState() != MatchState::ready)
+		{
+			return;
+		}
+		// the host may also have changed the difficulty, the match has to start with the advertised one
+		const Difficulty current = toDifficulty(room->GetDifficulty());
+		if (current == difficulty || TakePuzzle(current, puzzle))
+		{
+			StartMatch(*room, std::move(puzzle));
+			return;
+		}
+		difficulty = current;
+		seed = uint32_t(random());
 	}
 }
 
-Server::Rooms::iterator Server::FindRoom(int roomId)
+bool Server::TakePuzzle(Difficulty difficulty, Puzzle& puzzle)
 {
-	return std::find_if(rooms.begin(), rooms.end(), [&roomId](Room& r) {return r.GetId() == roomId; });
+	// only the difficulty the room advertises, a missing one is generated rather than swapped for another
+	if (puzzlePool && puzzlePool->TryPop(difficulty, puzzle))
+	{
+		return true;
+	}
+	const size_t bankSize = puzzleBank.GetCount(difficulty);
+	return bankSize > 0 && puzzleBank.Get(difficulty, std::uniform_int_distribution<size_t>(0, bankSize - 1)(random), puzzle);
 }
 
-void Server::RemoveUser(User& user)
+void Server::StartMatch(Room& room, Puzzle&& puzzle)
 {
-	if (user.room)
+	if (randomTransforms)
+	{
+		// banked puzzles are canonical, a random isomorph keeps repeats from being recognised
+		const SudokuTransform transform = SudokuTransform::CreateRandom(random);
+		puzzle.clues = transform.Apply(puzzle.clues);
+		puzzle.solution = transform.Apply(puzzle.solution);
+	}
+	room.StartCountdown(std::move(puzzle), Room::Clock::now());
+	const std::string clues = room.GetPuzzle().clues.ToString();
+	SendToPlayers(room, MessageType::start, [&room, &clues](MessageWriter& message, const Player&) {
+		message.Integer(Field::difficulty, int(room.GetPuzzle().difficulty))
+			.String(Field::puzzle, clues)
+			.Integer(Field::lifes, Room::START_LIFES)
+			.Integer(Field::countdown, Room::COUNTDOWN.count());
+	});
+}
+
+void Server::PlaceDigit(User& user, int cell, int digit)
+{
+	Room& room = *user.room;
+	Player* player = room.FindPlayer(user.name);
+	if (!player)
+	{
+		return;
+	}
+	const MoveResult result = room.PlaceDigit(*player, cell, digit, Room::Clock::now());
+	if (result == MoveResult::rejected)
 	{
-		if (user.room->GetGuest())
+		return;
+	}
+	const std::string as = player == &room.GetHost() ? "host" : "guest";
+	SendToPlayers(room, MessageType::move, [&](MessageWriter& message, const Player& recipient) {
+		message.String(Field::as, as)
+			.Integer(Field::cell, cell)
+			.Boolean(Field::correct, result == MoveResult::correct)
+			.Integer(Field::points, player->points)
+			.Integer(Field::lifes, player->lifes);
+		// the opponent only learns which cell was filled, never the digit
+		if (&recipient == player)
 		{
-			Json message;
-			if (user.room->GetGuest().name == user.name)
-			{
-				message["type"] = "changeRoom";
-				message["roomId"] = std::to_string(user.room->GetId());
-				message["change"] = "guest";
-				message["guest"] = "";
-				user.room->SetGuest("", nullptr);
-			}
-			else
+			message.Integer(Field::digit, digit);
+		}
+	});
+	if (room.GetState() == MatchState::finished)
+	{
+		SendToPlayers(room, MessageType::finish, [&room](MessageWriter& message, const Player&) {
+			message.String(Field::winner, room.GetWinner());
+		});
+	}
+}
+
+void Server::TakeHint(Connection& connection)
+{
+	int roomId = 0;
+	std::string name;
+	unsigned long match = 0;
+	LiveBoard board;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		User* user = connection.user;
+		Player* player = user && user->room ? user->room->FindPlayer(user->name) : nullptr;
+		if (!player)
+		{
+			return;
+		}
+		Room& room = *user->room;
+		const HintResult result = room.CheckHint(*player, Room::Clock::now());
+		if (result != HintResult::found)
+		{
+			if (result == HintResult::unaffordable)
 			{
-				message["type"] = "changeRoom";
-				message["roomId"] = std::to_string(user.room->GetId());
-				message["change"] = "host";
-				message["host"] = user.room->GetGuest().name;
-				user.room->ChangeGuestToHost();
+				SendHint(room, *player, result, Deduction());
 			}
-			BroadcastMessage(message);
+			return;
 		}
-		else
+		roomId = room.GetId();
+		name = user->name;
+		match = room.GetMatch();
+		board = player->board;
+	}
+	Deduction hint;
+	HintEngine engine;
+	const bool found = engine.FindPlacement(board, HintEngine::Clock::now() + hintBudget, hint);
+
+	// the room, the player or the match may be gone by now, they are looked up again
+	std::lock_guard<std::mutex> lock(mutex);
+	Room* room = FindRoom(roomId);
+	Player* player = room ? room->FindPlayer(name) : nullptr;
+	if (!player)
+	{
+		return;
+	}
+	const HintResult result = room->ChargeHint(*player, match, found ? &hint : nullptr, Room::Clock::now());
+	if (result != HintResult::rejected)
+	{
+		SendHint(*room, *player, result, hint);
+	}
+}
+
+void Server::SendHint(Room& room, const Player& player, HintResult result, const Deduction& hint)
+{
+	const std::string as = &player == &room.GetHost() ? "host" : "guest";
+	SendToPlayers(room, MessageType::hint, [&](MessageWriter& message, const Player& recipient) {
+		message.String(Field::as, as)
+			.Integer(Field::points, player.points)
+			.Integer(Field::lifes, player.lifes);
+		if (&recipient != &player)
 		{
-			RemoveRoom(*user.room);
+			return;
 		}
-	}
-	BroadcastRemoveUser(user);
-	users.erase(std::find_if(users.begin(), users.end(), [&user](User& u) {return u.name == user.name; }));
+		if (result != HintResult::found)
+		{
+			message.String(Field::reason, result == HintResult::unaffordable ? "not enough points or lifes" : "no logical step found");
+			return;
+		}
+		message.Integer(Field::cell, hint.cell)
+			.Integer(Field::digit, hint.digit)
+			.String(Field::technique, toString(hint.technique))
+			.BeginArray(Field::cells, hint.causes.size());
+		for (int cell : hint.causes)
+		{
+			message.IntegerElement(cell);
+		}
+		message.EndArray();
+	});
 }
 
-void Server::BroadcastAddUser(User& user)
+Room* Server::FindRoom(int roomId)
 {
-	Json message;
-	message["type"] = "addUser";
-	message["roomId"] = user.room ? std::to_string(user.room->GetId()) : "0";
-	message["name"] = user.name;
+	Rooms::iterator* it = roomsById.Find(roomId);
+	return it ? &**it : nullptr;
+}
 
-	for (auto& u : users)
+void Server::RemoveUser(User& user)
+{
+	if (user.room)
 	{
-		while(u.socket.sendJson(message) != Result::success);
+		LeaveRoom(user);
 	}
+	const std::string name = user.name;
+	users.erase(*usersByName.Find(name));
+	usersByName.Erase(name);
+	BroadcastRemoveUser(name);
 }
 
-void Server::BroadcastRemoveUser(User & user)
+void Server::BroadcastAddUser(User& user)
 {
-	Json message;
-	message["type"] = "removeUser";
-	message["name"] = user.name;
+	BroadcastMessage(MessageType::addUser, [&user](MessageWriter& message) {
+		message.RoomId(Field::roomId, user.room ? user.room->GetId() : 0)
+			.String(Field::name, user.name);
+	});
+}
 
-	for (auto& u : users)
-	{
-		u.socket.sendJson(message);
-	}
+void Server::BroadcastRemoveUser(const std::string& name)
+{
+	BroadcastMessage(MessageType::removeUser, [&name](MessageWriter& message) {
+		message.String(Field::name, name);
+	});
 }
 
 void Server::BroadcastAddRoom(const Room & room)
 {
-	Json message;
-	message["type"] = "addRoom";
-	message["id"] = std::to_string(room.GetId());
-	message["host"] = room.GetHost().name;
-	message["guest"] = room.GetGuest().name;
-	message["locked"] = room.IsLocked();
+	BroadcastMessage(MessageType::addRoom, [&room](MessageWriter& message) {
+		message.RoomId(Field::id, room.GetId())
+			.String(Field::host, room.GetHost().name)
+			.String(Field::guest, room.GetGuest().name)
+			.Boolean(Field::locked, room.IsLocked());
+	}, 0, room.GetId());
+}
 
-	for (auto& u : users)
+void Server::BroadcastRemoveRoom(int roomId)
+{
+	BroadcastMessage(MessageType::removeRoom, [roomId](MessageWriter& message) {
+		message.RoomId(Field::id, roomId);
+	}, 0, roomId);
+}
+
+bool Server::IsWatching(User& user, MessageType type, int roomId)
+{
+	RoomPage& page = user.page;
+	if (!page.paged || (user.room && user.room->GetId() == roomId))
 	{
-		u.socket.sendJson(message);
+		return true;
 	}
+	if (type == MessageType::addRoom)
+	{
+		const Room* room = FindRoom(roomId);
+		if (!room || !page.Accepts(*room))
+		{
+			return false;
+		}
+		page.ids.push_back(roomId);
+		return true;
+	}
+	if (!page.Contains(roomId))
+	{
+		return false;
+	}
+	if (type == MessageType::removeRoom)
+	{
+		page.ids.erase(std::lower_bound(page.ids.begin(), page.ids.end(), roomId));
+	}
+	return true;
 }
 
-void Server::BroadcastRemoveRoom(const Room& room)
+template<typename Write>
+void Server::BroadcastMessage(MessageType type, Write&& write, uint64_t coalesceKey, int roomId)
 {
-	Json message;
-	message["type"] = "removeRoom";
-	message["id"] = std::to_string(room.GetId());
-
+	// every lobby change gets the next version and is kept in both encodings for reconnecting clients
+	const long long version = (long long)lobbyLog.GetVersion() + 1;
+	LobbyLog::Frames frames;
+	for (Encoding encoding : { Encoding::json, Encoding::binary })
+	{
+		MessageWriter message(encoding, type);
+		write(message);
+		message.Integer(Field::version, version);
+		frames[size_t(encoding)] = std::make_shared<const std::string>(message.Release());
+	}
+	lobbyLog.Append(frames, roomId);
 	for (auto& u : users)
 	{
-		u.socket.sendJson(message);
+		// a paging client only follows the rooms of its page and the room it plays in
+		if (roomId != 0 && !IsWatching(u, type, roomId))
+		{
+			continue;
+		}
+		u.connection->Send(frames[size_t(u.connection->GetEncoding())], coalesceKey, coalesceKey != 0);
+		const size_t dropped = u.connection->GetDropped();
+		if (dropped != u.droppedFrames)
+		{
+			// the queue dropped a change this client needed, the lists replace what it has and
+			// every change still queued, so a resync cannot overflow the queue again
+			u.droppedFrames = dropped;
+			u.connection->Resync({ WriteUsers(u), WriteRooms(u) });
+		}
 	}
 }
 
-void Server::BroadcastMessage(const Json & message)
+template<typename Write>
+void Server::SendToPlayers(Room& room, MessageType type, Write&& write)
 {
-	for (auto& u : users)
+	for (const Player* player : { &room.GetHost(), &room.GetGuest() })
 	{
-		u.socket.sendJson(message);
+		if (*player)
+		{
+			MessageWriter message(player->connection->GetEncoding(), type);
+			write(message, *player);
+			player->connection->Send(message);
+		}
 	}
 }
 
-Result Server::HandleConnectionRequest(const std::string& name, ServerSocket&& socket)
+Result Server::HandleConnectionRequest(const Request& request, Connection& connection)
 {
+	const std::string& name = request.name;
+	const Encoding encoding = request.encoding;
 	if (name.size() < MIN_USER_NAME)
 	{
 		Json respond;
 		respond["type"] = "error";
 		respond["reason"] = "too short user name";
-		socket.sendJson(respond);
+		connection.Send(respond);
 		return Result::genericError;
 	}
 	if (name.size() > MAX_USER_NAME)
@@ -405,88 +821,147 @@ Result Server::HandleConnectionRequest(const std::string& name, ServerSocket&& s
 		Json respond;
 		respond["type"] = "error";
 		respond["reason"] = "too long user name";
-		socket.sendJson(respond);
+		connection.Send(respond);
 		return Result::genericError;
 	}
-	if (std::find_if(users.cbegin(), users.cend(), [&name](const User& user) {return user.name == name; }) != users.cend())
+	if (usersByName.Contains(name))
 	{
 		Json respond;
 		respond["type"] = "error";
 		respond["reason"] = "user with this name already exist";
-		socket.sendJson(respond);
+		connection.Send(respond);
 		return Result::genericError;
 	}
-	if (users.size() == MAX_NUMBER_OF_USERS)
+	if (users.size() >= maxNumberOfUsers)
 	{
 		Json respond;
 		respond["type"] = "error";
-		respond["reson"] = "server full";
-		socket.sendJson(respond);
+		respond["reason"] = "server full";
+		connection.Send(respond);
 		return Result::genericError;
 	}
 	Json respond;
 	respond["type"] = "connect";
-	socket.sendJson(respond);
+	respond["encoding"] = toString(encoding);
+	respond["epoch"] = lobbyEpoch;
+	connection.Send(respond);
+	connection.SetEncoding(encoding);
 
-	respond = serverConfig;
-	respond["type"] = "serverConfig";
-	socket.sendJson(respond);
-
-	User user(name, std::move(socket));
-	SendUsers(user);
+	MessageWriter config(encoding, MessageType::serverConfig);
+	for (const auto& item : serverConfig.items())
+	{
+		config.Value(item.key(), item.value());
+	}
+	connection.Send(config);
 
-	SendRooms(user);
+	User user(name, connection);
+	SyncLobby(user, request);
 
 	AddUser(std::move(user));
+	connection.user = &users.front();
 	return Result::success;
 }
 
-Result Server::HandleMessage(User & user, const Json & message)
+Result Server::HandleMessage(User & user, const Request & request)
 {
-	if (message["type"] == "createRoom")
+	const RequestHandler handler = REQUEST_HANDLERS[size_t(request.type)];
+	if (handler)
 	{
-		if (user.room == nullptr)
-		{
-			CreateRoom(user);
-		}
+		(this->*handler)(user, request);
 	}
-	else if (message["type"] == "join")
+	return Result::success;
+}
+
+void Server::HandleCreateRoom(User& user, const Request&)
+{
+	if (user.room != nullptr)
 	{
-		if (user.room == nullptr)
-		{
-			JoinRoom(user, message["roomId"]);
-		}
+		return;
 	}
-	else if (message["type"] == "lock")
+	if (rooms.size() >= maxNumberOfRooms)
 	{
-		if (user.room != nullptr && user.name == user.room->GetHost().name)
-		{
-			LockRoom(user.room->GetId(), message["lock"]);
-		}
+		MessageWriter message(user.connection->GetEncoding(), MessageType::error);
+		message.String(Field::reason, "too many rooms");
+		user.connection->Send(message);
+		return;
 	}
-	else if (message["type"] == "quit")
+	CreateRoom(user);
+}
+
+void Server::HandleJoin(User& user, const Request& request)
+{
+	if (user.room == nullptr)
 	{
-		if (user.room != nullptr)
-		{
-			QuitRoom(user);
-		}
+		JoinRoom(user, request.roomId);
 	}
-	else if (message["type"] == "changeRoom")
+}
+
+void Server::HandleLock(User& user, const Request& request)
+{
+	if (user.room != nullptr && user.name == user.room->GetHost().name && request.Has(Field::lock))
+	{
+		LockRoom(user.room->GetId(), request.lock);
+	}
+}
+
+void Server::HandleQuit(User& user, const Request&)
+{
+	if (user.room != nullptr)
+	{
+		QuitRoom(user);
+	}
+}
+
+void Server::HandleChangeRoom(User& user, const Request& request)
+{
+	if (user.room != nullptr && user.room->GetHost().name == user.name)
 	{
-		if (user.room != nullptr && user.room->GetHost().name == user.name)
+		if (request.change == "difficulty" && request.Has(Field::difficulty))
 		{
-			if (message["change"] == "difficulty")
-			{
-				ChangeRoomDifficulty(*user.room, message["difficulty"]);
-			}
+			ChangeRoomDifficulty(*user.room, request.difficulty);
 		}
 	}
-	/*else if (message["type"] == "kick")
+}
+
+void Server::HandlePlaceDigit(User& user, const Request& request)
+{
+	if (user.room != nullptr)
 	{
-		if (user.room != nullptr)
+		PlaceDigit(user, request.cell, request.digit);
+	}
+}
+
+void Server::HandleListRooms(User& user, const Request& request)
+{
+	SetRoomPage(user, request);
+	SendRoomsPage(user);
+}
+
+void Server::HandleStats(User& user, const Request&)
+{
+	// puzzle stock per difficulty, LOG is compiled out of release builds so this is where it can be watched
+	Json puzzles = Json::array();
+	for (size_t i = 0; i < size_t(Difficulty::count); ++i)
+	{
+		const Difficulty difficulty = Difficulty(i);
+		Json level;
+		level["difficulty"] = toString(difficulty);
+		level["bank"] = puzzleBank.GetCount(difficulty);
+		if (puzzlePool)
 		{
-			kickGuestFromRoom();
+			const PuzzlePool::Statistics statistics = puzzlePool->GetStatistics(difficulty);
+			level["depth"] = statistics.depth;
+			level["capacity"] = statistics.capacity;
+			level["generated"] = statistics.generated;
+			level["served"] = statistics.served;
+			level["misses"] = statistics.misses;
+			level["refillRate"] = statistics.refillRate;
 		}
-	}*/
-	return Result::success;
+		puzzles.push_back(std::move(level));
+	}
+	MessageWriter message(user.connection->GetEncoding(), MessageType::stats);
+	message.Value("users", users.size())
+		.Value("rooms", rooms.size())
+		.Value("puzzles", puzzles);
+	user.connection->Send(message);
 }
@@ -1,10 +1,19 @@
 #pragma once
 #include "ServerSocket.h"
 #include "TransmissionType.h"
+#include "IOCore.h"
+#include "HashIndex.h"
+#include "LobbyLog.h"
+#include "PuzzleBank.h"
+#include "PuzzlePool.h"
 #include "Room.h"
+#include "RoomIndex.h"
+#include "User.h"
+#include <array>
 #include <atomic>
 #include <list>
 #include <memory>
+#include <random>
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -12,61 +21,86 @@
 class Server
 {
 private:
-	struct User
-	{
-		User(const std::string& name, ServerSocket&& socket)
-			: name(name), socket(std::move(socket))
-		{}
-		User(User&& other)
-			: name(std::move(other.name)), socket(std::move(other.socket)), room(other.room)
-		{
-			other.room = nullptr;
-		}
-
-		std::string name;
-		ServerSocket socket;
-		Room* room = nullptr;
-		
-	};
 	using Users = std::list<User>;
 	using Rooms = std::list<Room>;
 public:
 	Server(const std::string& configPath);
 	void Start();
+	void Stop();
 	~Server();
 private:
-	void Listen(int backlog = 5);
-	void StartConnection(ServerSocket&& socket);
-	void WaitForMessages(const std::string& name);
+	void OnMessage(Connection& connection, const Request& request);
+	void OnDisconnect(Connection& connection);
 	void SendUsers(User& user);
+	SharedFrame WriteUsers(const User& user);
 	void AddUser(User&& user);
 	void RemoveUser(User& user);
 	void SendRooms(User& user);
+	void SendRoomsPage(User& user);
+	SharedFrame WriteRooms(User& user);
+	SharedFrame WriteRoomsPage(User& user);
+	void SetRoomPage(User& user, const Request& request);
+	void SyncLobby(User& user, const Request& request);
 	void CreateRoom(User& user);
 	void RemoveRoom(Room& room);
 	void JoinRoom(User& user, int roomId);
 	void LockRoom(int roomId, bool locked);
 	void QuitRoom(User& user);
+	void LeaveRoom(User& user);
 	void ChangeRoomDifficulty(Room& room, int difficulty);
-	Rooms::iterator FindRoom(int roomId);
+	void SetReady(Connection& connection, bool ready);
+	bool TakePuzzle(Difficulty difficulty, Puzzle& puzzle);
+	void StartMatch(Room& room, Puzzle&& puzzle);
+	void PlaceDigit(User& user, int cell, int digit);
+	void TakeHint(Connection& connection);
+	void SendHint(Room& room, const Player& player, HintResult result, const Deduction& hint);
+	Room* FindRoom(int roomId);
 	void BroadcastAddUser(User& user);
-	void BroadcastRemoveUser(User& user);
+	void BroadcastRemoveUser(const std::string& name);
 	void BroadcastAddRoom(const Room& room);
-	void BroadcastRemoveRoom(const Room& room);
-	void BroadcastMessage(const Json& message);
-	Result HandleConnectionRequest(const std::string& name, ServerSocket&& socket);
-	Result HandleMessage(User& user, const Json& message);
+	void BroadcastRemoveRoom(int roomId);
+	bool IsWatching(User& user, MessageType type, int roomId);
+	template<typename Write>
+	void BroadcastMessage(MessageType type, Write&& write, uint64_t coalesceKey = 0, int roomId = 0);
+	template<typename Write>
+	void SendToPlayers(Room& room, MessageType type, Write&& write);
+	Result HandleConnectionRequest(const Request& request, Connection& connection);
+	Result HandleMessage(User& user, const Request& request);
+	void HandleCreateRoom(User& user, const Request& request);
+	void HandleJoin(User& user, const Request& request);
+	void HandleLock(User& user, const Request& request);
+	void HandleQuit(User& user, const Request& request);
+	void HandleChangeRoom(User& user, const Request& request);
+	void HandlePlaceDigit(User& user, const Request& request);
+	void HandleListRooms(User& user, const Request& request);
+	void HandleStats(User& user, const Request& request);
 private:
+	using RequestHandler = void (Server::*)(User& user, const Request& request);
+	static const std::array<RequestHandler, size_t(MessageType::count)> REQUEST_HANDLERS;
 	Json serverConfig;
 	static constexpr const size_t MIN_USER_NAME = 3;
 	static constexpr const size_t MAX_USER_NAME = 10;
-	static constexpr const size_t MAX_NUMBER_OF_USERS = 10;
 	IPEndpoint serverEndpoint;
 	ServerSocket socket;
-	std::unique_ptr<std::thread> serverThread;
-	std::atomic<bool> alive = true;
 	std::mutex mutex;
 	Users users;
 	Rooms rooms;
+	HashIndex<std::string, Users::iterator> usersByName;
+	HashIndex<int, Rooms::iterator> roomsById;
+	RoomIndex roomIndex;
+	LobbyLog lobbyLog;
+	uint32_t lobbyEpoch = std::random_device{}() | 1u;
+	PuzzleBank puzzleBank;
+	std::unique_ptr<PuzzlePool> puzzlePool;
+	std::minstd_rand random{ std::random_device{}() };
+	size_t maxNumberOfUsers = 10000;
+	size_t maxNumberOfRooms = 5000;
+	size_t maxRoomsPage = 100;
+	bool randomTransforms = true;
+	SolverKind solverKind = SolverKind::bitboard;
+	std::chrono::milliseconds hintBudget = std::chrono::milliseconds(20);
+	std::chrono::milliseconds drainTimeout = std::chrono::milliseconds(2000);
+	std::unique_ptr<IOCore> ioCore;
+	bool stopped = false;
 };
 
@@ -2,6 +2,15 @@
 #include <assert.h>
 #include <sstream>
 
+// accepted sockets inherit the non-blocking mode of the listener on windows, accept4 gives linux the same
+static SocketHandle acceptHandle(SocketHandle handle, sockaddr* addr, SocketLength* len)
+{
+#ifdef __linux__
+    return ::accept4(handle, addr, len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    return ::accept(handle, addr, len);
+#endif
+}
 
 ServerSocket::ServerSocket(IPVersion ipversion, SocketHandle handle)
     : Socket(ipversion, handle)
@@ -34,11 +43,11 @@ Result ServerSocket::accept(ServerSocket& outSocket) const
     if (ipversion == IPVersion::IPv4) //IPv4
     {
         sockaddr_in addr = {};
-        int len = sizeof(sockaddr_in);
-        SocketHandle acceptedConnetionHandle = ::accept(handle, reinterpret_cast<sockaddr*>(&addr), &len);
+        SocketLength len = sizeof(sockaddr_in);
+        SocketHandle acceptedConnetionHandle = acceptHandle(handle, reinterpret_cast<sockaddr*>(&addr), &len);
         if (acceptedConnetionHandle == INVALID_SOCKET)
         {
-            int errorCode = WSAGetLastError();
+            int errorCode = lastSocketError();
             return errorCodeToResult(errorCode);
         }
         IPEndpoint newConnectionEndpoint(reinterpret_cast<sockaddr*>(&addr));
@@ -49,8 +58,8 @@ Result ServerSocket::accept(ServerSocket& outSocket) const
     else //IPv6
     {
         sockaddr_in6 addr = {};
-        int len = sizeof(sockaddr_in6);
-        SocketHandle acceptedConnetionHandle = ::accept(handle, reinterpret_cast<sockaddr*>(&addr), &len);
+        SocketLength len = sizeof(sockaddr_in6);
+        SocketHandle acceptedConnetionHandle = acceptHandle(handle, reinterpret_cast<sockaddr*>(&addr), &len);
         if (acceptedConnetionHandle == INVALID_SOCKET)
         {
             return Result::genericError;
@@ -0,0 +1,84 @@
+#include "ShutdownSignal.h"
+#include "NetworkException.h"
+#ifdef __linux__
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+#include <errno.h>
+#else
+#include <Windows.h>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#ifdef __linux__
+
+ShutdownSignal::ShutdownSignal()
+{
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	if (pthread_sigmask(SIG_BLOCK, &signals, nullptr) != 0)
+	{
+		throw NETWORK_EXCEPTION(errno);
+	}
+	signalHandle = signalfd(-1, &signals, SFD_CLOEXEC);
+	if (signalHandle == -1)
+	{
+		throw NETWORK_EXCEPTION(errno);
+	}
+}
+
+void ShutdownSignal::Wait()
+{
+	signalfd_siginfo info;
+	while (read(signalHandle, &info, sizeof(info)) != ssize_t(sizeof(info)) && errno == EINTR)
+	{
+	}
+}
+
+ShutdownSignal::~ShutdownSignal()
+{
+	close(signalHandle);
+}
+
+#else
+
+namespace
+{
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool signalled = false;
+
+	BOOL WINAPI onConsoleEvent(DWORD)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			signalled = true;
+		}
+		condition.notify_all();
+		return TRUE;
+	}
+}
+
+ShutdownSignal::ShutdownSignal()
+{
+	if (!SetConsoleCtrlHandler(onConsoleEvent, TRUE))
+	{
+		throw NETWORK_EXCEPTION(int(GetLastError()));
+	}
+}
+
+void ShutdownSignal::Wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	condition.wait(lock, []() { return signalled; });
+}
+
+ShutdownSignal::~ShutdownSignal()
+{
+	SetConsoleCtrlHandler(onConsoleEvent, FALSE);
+}
+
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+// SIGINT and SIGTERM on linux, console control events on windows; has to be created
+// before any other thread so the signals are blocked everywhere and only read here
+class ShutdownSignal
+{
+public:
+	ShutdownSignal();
+	ShutdownSignal(const ShutdownSignal&) = delete;
+	ShutdownSignal& operator=(const ShutdownSignal&) = delete;
+	void Wait();
+	~ShutdownSignal();
+private:
+#ifdef __linux__
+	int signalHandle = -1;
+#endif
+};
@@ -7,6 +7,7 @@
 #include "Json.h"
 #include "TransmissionType.h"
 #include "IOMode.h"
+#include "MessageFrame.h"
 
 using Json = nlohmann::json;
 
@@ -29,7 +30,9 @@ public:
 	//sending methods
 	Result send(const void* data, int numberOfBytes, int& bytesSent);
 	Result sendAll(const void* data, int numberOfBytes);
+	Result sendv(const SocketBuffer* buffers, int numberOfBuffers, int& bytesSent);
 	Result sendJson(const Json& jsonData);
+	Result sendFrame(const void* payload, int payloadSize);
 	Result sendBroadcast(const void* data, int numberOfBytes, int& bytesSent, unsigned short port);
 	Result sendAllBroadcast(const void* data, int numberOfBytes, unsigned short port);
 	Result sendJsonBroadcast(const Json& jsonData, unsigned short port);
@@ -40,6 +43,7 @@ public:
 	Result recieve(void* destination, int numberOfBytes, int& bytesRecieved);
 	Result recieveAll(void* destination, int numberOfBytes);
 	Result recieveJson(Json& jsonDestination);
+	Result recieveFrame(std::string& payload);
 	Result recieveTime(unsigned long long& time);
 	//getters
 	Result getIPEndpoint(IPEndpoint& ipEndpoint) const;
@@ -50,6 +54,7 @@ public:
 protected:
 	IPVersion ipversion = IPVersion::IPv4;
 	SocketHandle handle = INVALID_SOCKET;
+	std::string recieveBuffer;
 };
 
 std::ostream& operator<<(std::ostream& stream, const Socket& socket);
\ No newline at end of file
@@ -1,6 +1,63 @@
 #pragma once
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+
+using SocketHandle = int;
+using SocketLength = socklen_t;
+using BOOL = int;
+using DWORD = unsigned long;
+
+constexpr const SocketHandle INVALID_SOCKET = -1;
+constexpr const int SOCKET_ERROR = -1;
+constexpr const BOOL TRUE = 1;
+constexpr const BOOL FALSE = 0;
+
+inline int lastSocketError()
+{
+	return errno;
+}
+
+inline int closeSocket(SocketHandle handle)
+{
+	return ::close(handle);
+}
+
+using SocketBuffer = iovec;
+
+inline SocketBuffer makeSocketBuffer(const void* data, size_t size)
+{
+	return SocketBuffer{ const_cast<void*>(data), size };
+}
+#else
 #define WIN32_LEAN_AND_MEAN
 #include <WinSock2.h>
 
-
 using SocketHandle = SOCKET;
+using SocketLength = int;
+
+inline int lastSocketError()
+{
+	return WSAGetLastError();
+}
+
+inline int closeSocket(SocketHandle handle)
+{
+	return closesocket(handle);
+}
+
+using SocketBuffer = WSABUF;
+
+inline SocketBuffer makeSocketBuffer(const void* data, size_t size)
+{
+	SocketBuffer buffer;
+	buffer.len = ULONG(size);
+	buffer.buf = const_cast<char*>(static_cast<const char*>(data));
+	return buffer;
+}
+#endif
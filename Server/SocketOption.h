@@ -6,5 +6,6 @@ enum class SocketOption
 	TCP_NoDelay,
 	IPV6_Only,
 	SO_Broadcast,
+	SO_ReuseAddress,
 	SO_RecieveTimeout
 };
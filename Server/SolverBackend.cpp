@@ -0,0 +1,38 @@
+#include "SolverBackend.h"
+#include "DancingLinksSolver.h"
+#include "SudokuSolver.h"
+
+namespace
+{
+	constexpr const char* SOLVER_NAMES[] = { "bitboard", "dancingLinks" };
+	static_assert(sizeof(SOLVER_NAMES) / sizeof(*SOLVER_NAMES) == size_t(SolverKind::count), "missing solver name");
+}
+
+const char* toString(SolverKind kind)
+{
+	return SOLVER_NAMES[size_t(kind)];
+}
+
+bool toSolverKind(const std::string& name, SolverKind& kind)
+{
+	for (size_t i = 0; i < size_t(SolverKind::count); ++i)
+	{
+		if (name == SOLVER_NAMES[i])
+		{
+			kind = SolverKind(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+std::unique_ptr<SolverBackend> createSolver(SolverKind kind)
+{
+	switch (kind)
+	{
+	case SolverKind::dancingLinks:
+		return std::make_unique<DancingLinksSolver>();
+	default:
+		return std::make_unique<SudokuSolver>();
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "SudokuBoard.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+
+enum class SolverKind : uint8_t
+{
+	bitboard,
+	dancingLinks,
+	count
+};
+
+const char* toString(SolverKind kind);
+bool toSolverKind(const std::string& name, SolverKind& kind);
+
+class SolverBackend
+{
+public:
+	virtual ~SolverBackend() = default;
+	virtual bool Solve(SudokuBoard& board) = 0;
+	virtual size_t CountSolutions(const SudokuBoard& board, size_t limit = 2) = 0;
+	virtual bool HasSolutionWithout(const SudokuBoard& board, int cell, int digit) = 0;
+	virtual size_t GetNumberOfGuesses() const = 0;
+};
+
+std::unique_ptr<SolverBackend> createSolver(SolverKind kind);
@@ -0,0 +1,73 @@
+#include "SudokuBoard.h"
+
+SudokuBoard::SudokuBoard()
+	: cells{}, rows{}, columns{}, boxes{}
+{
+}
+
+bool SudokuBoard::FromString(const std::string& text, SudokuBoard& board)
+{
+	if (text.size() != NUMBER_OF_CELLS)
+	{
+		return false;
+	}
+	board = SudokuBoard();
+	for (int cell = 0; cell < NUMBER_OF_CELLS; ++cell)
+	{
+		const char c = text[cell];
+		if (c >= '1' && c <= '9')
+		{
+			if (!board.Place(cell, c - '0'))
+			{
+				return false;
+			}
+		}
+		else if (c != '.' && c != '0')
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string SudokuBoard::ToString() const
+{
+	std::string text(NUMBER_OF_CELLS, '.');
+	for (int cell = 0; cell < NUMBER_OF_CELLS; ++cell)
+	{
+		if (cells[cell])
+		{
+			text[cell] = char('0' + cells[cell]);
+		}
+	}
+	return text;
+}
+
+bool SudokuBoard::Place(int cell, int digit)
+{
+	if (!CanPlace(cell, digit))
+	{
+		return false;
+	}
+	const DigitMask mask = ToMask(digit);
+	cells[cell] = uint8_t(digit);
+	rows[RowOf(cell)] |= mask;
+	columns[ColumnOf(cell)] |= mask;
+	boxes[BoxOf(cell)] |= mask;
+	++filled;
+	return true;
+}
+
+void SudokuBoard::Clear(int cell)
+{
+	if (!cells[cell])
+	{
+		return;
+	}
+	const DigitMask mask = ToMask(cells[cell]);
+	cells[cell] = 0;
+	rows[RowOf(cell)] &= ~mask;
+	columns[ColumnOf(cell)] &= ~mask;
+	boxes[BoxOf(cell)] &= ~mask;
+	--filled;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include "SudokuTables.h"
+#include <string>
+
+class SudokuBoard
+{
+public:
+	static constexpr const int SIZE = SudokuTables::SIZE;
+	static constexpr const int NUMBER_OF_CELLS = SudokuTables::NUMBER_OF_CELLS;
+	static constexpr const DigitMask ALL_DIGITS = SudokuTables::ALL_DIGITS;
+public:
+	SudokuBoard();
+	static bool FromString(const std::string& text, SudokuBoard& board);
+	std::string ToString() const;
+	int Get(int cell) const
+	{
+		return cells[cell];
+	}
+	DigitMask GetCandidates(int cell) const
+	{
+		if (cells[cell])
+		{
+			return 0;
+		}
+		return ALL_DIGITS & ~(rows[RowOf(cell)] | columns[ColumnOf(cell)] | boxes[BoxOf(cell)]);
+	}
+	bool CanPlace(int cell, int digit) const
+	{
+		return (GetCandidates(cell) & ToMask(digit)) != 0;
+	}
+	bool Place(int cell, int digit);
+	void Clear(int cell);
+	int GetNumberOfFilled() const
+	{
+		return filled;
+	}
+	bool IsSolved() const
+	{
+		return filled == NUMBER_OF_CELLS;
+	}
+	static int RowOf(int cell)
+	{
+		return sudokuTables.rowOf[cell];
+	}
+	static int ColumnOf(int cell)
+	{
+		return sudokuTables.columnOf[cell];
+	}
+	static int BoxOf(int cell)
+	{
+		return sudokuTables.boxOf[cell];
+	}
+	static DigitMask ToMask(int digit)
+	{
+		return sudokuTables.digitMasks[digit];
+	}
+	static int ToDigit(DigitMask mask)
+	{
+		return sudokuTables.digitOf[mask];
+	}
+private:
+	uint8_t cells[NUMBER_OF_CELLS];
+	DigitMask rows[SIZE];
+	DigitMask columns[SIZE];
+	DigitMask boxes[SIZE];
+	int filled = 0;
+};
@@ -0,0 +1,126 @@
+#include "SudokuCanonicalizer.h"
+
+SudokuCanonicalizer::SudokuCanonicalizer()
+{
+	columnOrders.reserve(NUMBER_OF_COLUMN_ORDERS);
+	uint8_t stacks[3] = { 0, 1, 2 };
+	do
+	{
+		for (int orders = 0; orders < 6 * 6 * 6; ++orders)
+		{
+			std::array<uint8_t, SudokuBoard::SIZE> order;
+			for (int stack = 0, rest = orders; stack < 3; ++stack, rest /= 6)
+			{
+				uint8_t offsets[3] = { 0, 1, 2 };
+				for (int permutation = rest % 6; permutation > 0; --permutation)
+				{
+					std::next_permutation(std::begin(offsets), std::end(offsets));
+				}
+				for (int i = 0; i < 3; ++i)
+				{
+					order[stack * 3 + i] = uint8_t(stacks[stack] * 3 + offsets[i]);
+				}
+			}
+			columnOrders.push_back(order);
+		}
+	} while (std::next_permutation(std::begin(stacks), std::end(stacks)));
+}
+
+SudokuBoard SudokuCanonicalizer::Canonicalize(const SudokuBoard& board, SudokuTransform* transform)
+{
+	for (int row = 0; row < SudokuBoard::SIZE; ++row)
+	{
+		for (int column = 0; column < SudokuBoard::SIZE; ++column)
+		{
+			cells[0][row * SudokuBoard::SIZE + column] = uint8_t(board.Get(row * SudokuBoard::SIZE + column));
+			cells[1][column * SudokuBoard::SIZE + row] = uint8_t(board.Get(row * SudokuBoard::SIZE + column));
+		}
+	}
+	hasBest = false;
+	extended.clear();
+	Candidate start;
+	std::fill(std::begin(start.transform.digits), std::end(start.transform.digits), uint8_t(0));
+	start.nextDigit = 1;
+	for (int transpose = 0; transpose < 2; ++transpose)
+	{
+		start.transform.transpose = transpose != 0;
+		for (const auto& order : columnOrders)
+		{
+			std::copy(order.begin(), order.end(), start.transform.columns);
+			for (int sourceRow = 0; sourceRow < SudokuBoard::SIZE; ++sourceRow)
+			{
+				Extend(start, 0, sourceRow);
+			}
+		}
+	}
+	for (int row = 1; row < SudokuBoard::SIZE; ++row)
+	{
+		candidates.swap(extended);
+		extended.clear();
+		hasBest = false;
+		for (const Candidate& candidate : candidates)
+		{
+			// a new band may start with any row of an unused band, otherwise the band is finished first
+			const int first = row - row % 3;
+			for (int sourceRow = 0; sourceRow < SudokuBoard::SIZE; ++sourceRow)
+			{
+				bool allowed = true;
+				for (int previous = 0; previous < row && allowed; ++previous)
+				{
+					const int previousRow = candidate.transform.rows[previous];
+					allowed = previous < first ? previousRow / 3 != sourceRow / 3 : previousRow != sourceRow && previousRow / 3 == sourceRow / 3;
+				}
+				if (allowed)
+				{
+					Extend(candidate, row, sourceRow);
+				}
+			}
+		}
+	}
+	Candidate& result = extended.front();
+	// digits missing from the puzzle take the unused labels in order
+	for (int digit = 1; digit <= SudokuBoard::SIZE; ++digit)
+	{
+		if (!result.transform.digits[digit])
+		{
+			result.transform.digits[digit] = result.nextDigit++;
+		}
+	}
+	if (transform)
+	{
+		*transform = result.transform;
+	}
+	return result.transform.Apply(board);
+}
+
+void SudokuCanonicalizer::Extend(Candidate candidate, int row, int sourceRow)
+{
+	candidate.transform.rows[row] = uint8_t(sourceRow);
+	const uint8_t* source = cells[candidate.transform.transpose ? 1 : 0] + sourceRow * SudokuBoard::SIZE;
+	uint8_t values[SudokuBoard::SIZE];
+	bool smaller = !hasBest;
+	for (int column = 0; column < SudokuBoard::SIZE; ++column)
+	{
+		const int digit = source[candidate.transform.columns[column]];
+		if (digit && !candidate.transform.digits[digit])
+		{
+			candidate.transform.digits[digit] = candidate.nextDigit++;
+		}
+		values[column] = candidate.transform.digits[digit];
+		if (!smaller)
+		{
+			if (values[column] > best[column])
+			{
+				return;
+			}
+			smaller = values[column] < best[column];
+		}
+	}
+	if (smaller)
+	{
+		std::copy(std::begin(values), std::end(values), best);
+		hasBest = true;
+		extended.clear();
+	}
+	extended.push_back(candidate);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "SudokuTransform.h"
+#include <array>
+#include <vector>
+
+// Minlex canonical form: the lexicographically smallest row-major string, blanks as 0, over
+// all transpositions, band/stack and line permutations and digit relabelings. Rows are fixed
+// one at a time and only the transforms tied for the smallest prefix are carried forward.
+class SudokuCanonicalizer
+{
+private:
+	struct Candidate
+	{
+		SudokuTransform transform;
+		uint8_t nextDigit;
+	};
+public:
+	SudokuCanonicalizer();
+	SudokuBoard Canonicalize(const SudokuBoard& board, SudokuTransform* transform = nullptr);
+private:
+	void Extend(Candidate candidate, int row, int sourceRow);
+private:
+	static constexpr const int NUMBER_OF_COLUMN_ORDERS = 6 * 6 * 6 * 6;
+	std::vector<std::array<uint8_t, SudokuBoard::SIZE>> columnOrders;
+	uint8_t cells[2][SudokuBoard::NUMBER_OF_CELLS];
+	uint8_t best[SudokuBoard::SIZE];
+	bool hasBest = false;
+	std::vector<Candidate> candidates;
+	std::vector<Candidate> extended;
+};
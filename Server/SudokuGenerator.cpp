@@ -0,0 +1,125 @@
+#include "SudokuGenerator.h"
+#include <algorithm>
+#include <cstdlib>
+
+SudokuGenerator::SudokuGenerator()
+	: SudokuGenerator(std::random_device{}())
+{
+}
+
+SudokuGenerator::SudokuGenerator(uint32_t seed, SolverKind solverKind)
+	: random(seed), solver(createSolver(solverKind))
+{
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		order[cell] = cell;
+	}
+}
+
+Puzzle SudokuGenerator::Generate(Difficulty difficulty)
+{
+	Puzzle best;
+	int bestDistance = -1;
+	for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt)
+	{
+		Puzzle puzzle;
+		puzzle.solution = CreateSolution();
+		puzzle.clues = puzzle.solution;
+		RemoveClues(puzzle.clues);
+		puzzle.difficulty = grader.Grade(puzzle.clues);
+		if (puzzle.difficulty > difficulty)
+		{
+			puzzle.difficulty = AddClues(puzzle.clues, puzzle.solution, difficulty);
+		}
+		if (puzzle.difficulty == difficulty)
+		{
+			return puzzle;
+		}
+		const int distance = std::abs(int(puzzle.difficulty) - int(difficulty));
+		if (bestDistance < 0 || distance < bestDistance)
+		{
+			best = puzzle;
+			bestDistance = distance;
+		}
+	}
+	return best;
+}
+
+SudokuBoard SudokuGenerator::CreateSolution()
+{
+	for (;;)
+	{
+		SudokuBoard board;
+		ShuffleCells();
+		for (int i = 0; i < NUMBER_OF_SEEDS; ++i)
+		{
+			DigitMask candidates = board.GetCandidates(order[i]);
+			for (int skip = std::uniform_int_distribution<int>(0, SudokuBoard::SIZE - 1)(random); skip > 0 && (candidates & (candidates - 1)); --skip)
+			{
+				candidates &= candidates - 1;
+			}
+			if (candidates)
+			{
+				board.Place(order[i], SudokuBoard::ToDigit(DigitMask(candidates & -candidates)));
+			}
+		}
+		if (!solver->Solve(board))
+		{
+			continue;
+		}
+		// the solver fills cells in a fixed order, relabeling the digits hides that bias
+		int digits[SudokuBoard::SIZE + 1] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		std::shuffle(digits + 1, digits + SudokuBoard::SIZE + 1, random);
+		SudokuBoard solution;
+		for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+		{
+			solution.Place(cell, digits[board.Get(cell)]);
+		}
+		return solution;
+	}
+}
+
+void SudokuGenerator::RemoveClues(SudokuBoard& puzzle)
+{
+	ShuffleCells();
+	for (int cell : order)
+	{
+		const int digit = puzzle.Get(cell);
+		puzzle.Clear(cell);
+		if (solver->HasSolutionWithout(puzzle, cell, digit))
+		{
+			puzzle.Place(cell, digit);
+		}
+	}
+}
+
+Difficulty SudokuGenerator::AddClues(SudokuBoard& puzzle, const SudokuBoard& solution, Difficulty difficulty)
+{
+	// clues that would overshoot below the target are taken back, so the grade can only step down onto it
+	Difficulty easier = difficulty;
+	ShuffleCells();
+	for (int cell : order)
+	{
+		if (puzzle.Get(cell))
+		{
+			continue;
+		}
+		puzzle.Place(cell, solution.Get(cell));
+		const Difficulty grade = grader.Grade(puzzle);
+		if (grade == difficulty)
+		{
+			return grade;
+		}
+		if (grade < difficulty)
+		{
+			puzzle.Clear(cell);
+			easier = grade;
+		}
+	}
+	return easier;
+}
+
+void SudokuGenerator::ShuffleCells()
+{
+	std::shuffle(std::begin(order), std::end(order), random);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "SudokuBoard.h"
+#include "SudokuGrader.h"
+#include "SolverBackend.h"
+#include <memory>
+#include <random>
+
+struct Puzzle
+{
+	SudokuBoard clues;
+	SudokuBoard solution;
+	Difficulty difficulty = Difficulty::easy;
+};
+
+class SudokuGenerator
+{
+public:
+	SudokuGenerator();
+	SudokuGenerator(uint32_t seed, SolverKind solverKind = SolverKind::bitboard);
+	Puzzle Generate(Difficulty difficulty);
+private:
+	SudokuBoard CreateSolution();
+	void RemoveClues(SudokuBoard& puzzle);
+	Difficulty AddClues(SudokuBoard& puzzle, const SudokuBoard& solution, Difficulty difficulty);
+	void ShuffleCells();
+private:
+	static constexpr const int NUMBER_OF_SEEDS = 11;
+	static constexpr const int MAX_ATTEMPTS = 32;
+	std::mt19937 random;
+	std::unique_ptr<SolverBackend> solver;
+	SudokuGrader grader;
+	int order[SudokuBoard::NUMBER_OF_CELLS];
+};
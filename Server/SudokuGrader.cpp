@@ -0,0 +1,204 @@
+#include "SudokuGrader.h"
+#include "SudokuTables.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr const char* DIFFICULTY_NAMES[] = { "easy", "medium", "hard", "extreme" };
+	static_assert(sizeof(DIFFICULTY_NAMES) / sizeof(*DIFFICULTY_NAMES) == size_t(Difficulty::count), "missing difficulty name");
+
+	bool isInUnit(int cell, int unit)
+	{
+		return sudokuTables.unitsOf[cell][unit / SudokuBoard::SIZE] == unit;
+	}
+}
+
+const char* toString(Difficulty difficulty)
+{
+	return DIFFICULTY_NAMES[size_t(difficulty)];
+}
+
+Difficulty toDifficulty(int difficulty)
+{
+	return Difficulty(std::clamp(difficulty, 0, int(Difficulty::count) - 1));
+}
+
+Difficulty SudokuGrader::Grade(const SudokuBoard& puzzle)
+{
+	filled = puzzle.GetNumberOfFilled();
+	broken = false;
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		cells[cell] = uint8_t(puzzle.Get(cell));
+		candidates[cell] = puzzle.GetCandidates(cell);
+	}
+	Difficulty difficulty = Difficulty::easy;
+	while (filled < SudokuBoard::NUMBER_OF_CELLS && !broken)
+	{
+		if (ApplySingles())
+		{
+			continue;
+		}
+		if (ApplyLockedCandidates())
+		{
+			difficulty = std::max(difficulty, Difficulty::medium);
+			continue;
+		}
+		if (ApplyNakedSubsets())
+		{
+			difficulty = std::max(difficulty, Difficulty::hard);
+			continue;
+		}
+		return Difficulty::extreme;
+	}
+	return broken ? Difficulty::extreme : difficulty;
+}
+
+bool SudokuGrader::Assign(int cell, DigitMask digit)
+{
+	cells[cell] = uint8_t(SudokuBoard::ToDigit(digit));
+	candidates[cell] = 0;
+	++filled;
+	for (int peer : sudokuTables.peers[cell])
+	{
+		if (candidates[peer] & digit)
+		{
+			Eliminate(peer, digit);
+		}
+	}
+	return true;
+}
+
+bool SudokuGrader::Eliminate(int cell, DigitMask digits)
+{
+	if (!(candidates[cell] & digits))
+	{
+		return false;
+	}
+	candidates[cell] &= ~digits;
+	broken = broken || !candidates[cell];
+	return true;
+}
+
+bool SudokuGrader::ApplySingles()
+{
+	bool progress = false;
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		if (!cells[cell] && sudokuTables.bitCounts[candidates[cell]] == 1)
+		{
+			progress = Assign(cell, candidates[cell]);
+		}
+	}
+	for (const auto& unit : sudokuTables.units)
+	{
+		DigitMask once = 0;
+		DigitMask twice = 0;
+		for (int cell : unit)
+		{
+			twice |= once & candidates[cell];
+			once |= candidates[cell];
+		}
+		const DigitMask hidden = once & ~twice;
+		for (int cell : unit)
+		{
+			const DigitMask single = candidates[cell] & hidden;
+			if (single && sudokuTables.bitCounts[single] == 1)
+			{
+				progress = Assign(cell, single);
+			}
+		}
+	}
+	return progress;
+}
+
+bool SudokuGrader::ApplyLockedCandidates()
+{
+	bool progress = false;
+	for (int unit = 0; unit < SudokuTables::NUMBER_OF_UNITS; ++unit)
+	{
+		const bool isBox = unit >= 2 * SudokuBoard::SIZE;
+		for (DigitMask digit = 1; digit <= SudokuBoard::ALL_DIGITS; digit <<= 1)
+		{
+			DigitMask rows = 0;
+			DigitMask columns = 0;
+			DigitMask boxes = 0;
+			for (int cell : sudokuTables.units[unit])
+			{
+				if (candidates[cell] & digit)
+				{
+					rows |= DigitMask(1u << SudokuBoard::RowOf(cell));
+					columns |= DigitMask(1u << SudokuBoard::ColumnOf(cell));
+					boxes |= DigitMask(1u << SudokuBoard::BoxOf(cell));
+				}
+			}
+			// pointing: a box confines the digit to one line; claiming: a line confines it to one box
+			int target = -1;
+			if (isBox && sudokuTables.bitCounts[rows] == 1)
+			{
+				target = SudokuBoard::ToDigit(rows) - 1;
+			}
+			else if (isBox && sudokuTables.bitCounts[columns] == 1)
+			{
+				target = SudokuBoard::SIZE + SudokuBoard::ToDigit(columns) - 1;
+			}
+			else if (!isBox && sudokuTables.bitCounts[boxes] == 1)
+			{
+				target = 2 * SudokuBoard::SIZE + SudokuBoard::ToDigit(boxes) - 1;
+			}
+			if (target < 0)
+			{
+				continue;
+			}
+			for (int cell : sudokuTables.units[target])
+			{
+				if (!isInUnit(cell, unit))
+				{
+					progress = Eliminate(cell, digit) || progress;
+				}
+			}
+		}
+	}
+	return progress;
+}
+
+bool SudokuGrader::ApplyNakedSubsets()
+{
+	bool progress = false;
+	for (const auto& unit : sudokuTables.units)
+	{
+		int empty[SudokuBoard::SIZE];
+		int numberOfEmpty = 0;
+		for (int cell : unit)
+		{
+			if (!cells[cell])
+			{
+				empty[numberOfEmpty++] = cell;
+			}
+		}
+		for (int i = 0; i < numberOfEmpty; ++i)
+		{
+			for (int j = i + 1; j < numberOfEmpty; ++j)
+			{
+				for (int k = j; k < numberOfEmpty; ++k)
+				{
+					// k == j describes a pair, anything above it a triple
+					const int size = k == j ? 2 : 3;
+					const DigitMask digits = candidates[empty[i]] | candidates[empty[j]] | candidates[empty[k]];
+					if (sudokuTables.bitCounts[digits] != size)
+					{
+						continue;
+					}
+					for (int l = 0; l < numberOfEmpty; ++l)
+					{
+						if (l != i && l != j && l != k)
+						{
+							progress = Eliminate(empty[l], digits) || progress;
+						}
+					}
+				}
+			}
+		}
+	}
+	return progress;
+}
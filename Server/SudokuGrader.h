@@ -0,0 +1,32 @@
+#pragma once
+#include "SudokuBoard.h"
+#include <string>
+
+enum class Difficulty : uint8_t
+{
+	easy,
+	medium,
+	hard,
+	extreme,
+	count
+};
+
+const char* toString(Difficulty difficulty);
+Difficulty toDifficulty(int difficulty);
+
+class SudokuGrader
+{
+public:
+	Difficulty Grade(const SudokuBoard& puzzle);
+private:
+	bool Assign(int cell, DigitMask digit);
+	bool Eliminate(int cell, DigitMask digits);
+	bool ApplySingles();
+	bool ApplyLockedCandidates();
+	bool ApplyNakedSubsets();
+private:
+	uint8_t cells[SudokuBoard::NUMBER_OF_CELLS];
+	DigitMask candidates[SudokuBoard::NUMBER_OF_CELLS];
+	int filled = 0;
+	bool broken = false;
+};
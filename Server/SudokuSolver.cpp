@@ -0,0 +1,203 @@
+#include "SudokuSolver.h"
+#include "SudokuTables.h"
+#include <algorithm>
+
+bool SudokuSolver::Solve(SudokuBoard& board)
+{
+	if (CountSolutions(board, 1) == 0)
+	{
+		return false;
+	}
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		if (!board.Get(cell))
+		{
+			board.Place(cell, firstSolution.cells[cell]);
+		}
+	}
+	return true;
+}
+
+size_t SudokuSolver::CountSolutions(const SudokuBoard& board, size_t limit)
+{
+	State state;
+	Load(board, state, limit);
+	Search(state);
+	return solutions;
+}
+
+bool SudokuSolver::HasSolutionWithout(const SudokuBoard& board, int cell, int digit)
+{
+	State state;
+	Load(board, state, 1);
+	DigitMask& candidates = state.candidates[cell];
+	candidates &= ~SudokuBoard::ToMask(digit);
+	if (!candidates)
+	{
+		return false;
+	}
+	if (sudokuTables.bitCounts[candidates] == 1)
+	{
+		pending[numberOfPending++] = cell;
+	}
+	Search(state);
+	return solutions > 0;
+}
+
+size_t SudokuSolver::GetNumberOfGuesses() const
+{
+	return guesses;
+}
+
+void SudokuSolver::PropagateSingles(const SudokuBoard& board, Propagation& result)
+{
+	State state;
+	Load(board, state, 1);
+	result.contradiction = !Propagate(state);
+	numberOfPending = 0;
+	std::copy(std::begin(state.cells), std::end(state.cells), result.cells);
+	std::copy(std::begin(state.candidates), std::end(state.candidates), result.candidates);
+	result.filled = state.filled;
+}
+
+void SudokuSolver::Load(const SudokuBoard& board, State& state, size_t limit)
+{
+	this->limit = limit ? limit : 1;
+	solutions = 0;
+	guesses = 0;
+	numberOfPending = 0;
+	state.filled = board.GetNumberOfFilled();
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS; ++cell)
+	{
+		state.cells[cell] = uint8_t(board.Get(cell));
+		state.candidates[cell] = board.GetCandidates(cell);
+		if (!state.cells[cell] && sudokuTables.bitCounts[state.candidates[cell]] <= 1)
+		{
+			pending[numberOfPending++] = cell;
+		}
+	}
+}
+
+bool SudokuSolver::Assign(State& state, int cell, DigitMask digit)
+{
+	if (!(state.candidates[cell] & digit))
+	{
+		return false;
+	}
+	state.cells[cell] = uint8_t(SudokuBoard::ToDigit(digit));
+	state.candidates[cell] = 0;
+	++state.filled;
+	for (int peer : sudokuTables.peers[cell])
+	{
+		DigitMask& candidates = state.candidates[peer];
+		if (candidates & digit)
+		{
+			candidates &= ~digit;
+			if (sudokuTables.bitCounts[candidates] <= 1)
+			{
+				if (!candidates)
+				{
+					return false;
+				}
+				pending[numberOfPending++] = peer;
+			}
+		}
+	}
+	return true;
+}
+
+bool SudokuSolver::Propagate(State& state)
+{
+	bool changed = true;
+	while (changed)
+	{
+		while (numberOfPending > 0)
+		{
+			const int cell = pending[--numberOfPending];
+			if (state.cells[cell])
+			{
+				continue;
+			}
+			if (!Assign(state, cell, state.candidates[cell]))
+			{
+				return false;
+			}
+		}
+		changed = false;
+		for (const auto& unit : sudokuTables.units)
+		{
+			DigitMask once = 0;
+			DigitMask twice = 0;
+			DigitMask placed = 0;
+			for (int cell : unit)
+			{
+				placed |= sudokuTables.digitMasks[state.cells[cell]];
+				twice |= once & state.candidates[cell];
+				once |= state.candidates[cell];
+			}
+			if ((once | placed) != SudokuBoard::ALL_DIGITS)
+			{
+				return false;
+			}
+			const DigitMask hidden = once & ~twice;
+			if (!hidden)
+			{
+				continue;
+			}
+			for (int cell : unit)
+			{
+				const DigitMask single = state.candidates[cell] & hidden;
+				if (!single)
+				{
+					continue;
+				}
+				if ((single & (single - 1)) || !Assign(state, cell, single))
+				{
+					return false;
+				}
+				changed = true;
+			}
+		}
+		changed = changed || numberOfPending > 0;
+	}
+	return true;
+}
+
+bool SudokuSolver::Search(State& state)
+{
+	if (!Propagate(state))
+	{
+		numberOfPending = 0;
+		return false;
+	}
+	if (state.filled == SudokuBoard::NUMBER_OF_CELLS)
+	{
+		if (solutions++ == 0)
+		{
+			firstSolution = state;
+		}
+		return solutions >= limit;
+	}
+	int bestCell = -1;
+	int bestCount = SudokuBoard::SIZE + 1;
+	for (int cell = 0; cell < SudokuBoard::NUMBER_OF_CELLS && bestCount > 2; ++cell)
+	{
+		const int count = sudokuTables.bitCounts[state.candidates[cell]];
+		if (count > 0 && count < bestCount)
+		{
+			bestCount = count;
+			bestCell = cell;
+		}
+	}
+	for (DigitMask candidates = state.candidates[bestCell]; candidates; candidates &= candidates - 1)
+	{
+		State guess = state;
+		++guesses;
+		if (Assign(guess, bestCell, DigitMask(candidates & -candidates)) && Search(guess))
+		{
+			return true;
+		}
+		numberOfPending = 0;
+	}
+	return false;
+}
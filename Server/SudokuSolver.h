@@ -0,0 +1,33 @@
+#pragma once
+#include "SolverBackend.h"
+#include "PropagationKernel.h"
+
+class SudokuSolver final : public SolverBackend
+{
+private:
+	struct State
+	{
+		uint8_t cells[SudokuBoard::NUMBER_OF_CELLS];
+		DigitMask candidates[SudokuBoard::NUMBER_OF_CELLS];
+		int filled;
+	};
+public:
+	bool Solve(SudokuBoard& board) override;
+	size_t CountSolutions(const SudokuBoard& board, size_t limit = 2) override;
+	bool HasSolutionWithout(const SudokuBoard& board, int cell, int digit) override;
+	size_t GetNumberOfGuesses() const override;
+	// naked and hidden singles only, the reference the propagation kernels are validated against
+	void PropagateSingles(const SudokuBoard& board, Propagation& result);
+private:
+	void Load(const SudokuBoard& board, State& state, size_t limit);
+	bool Assign(State& state, int cell, DigitMask digit);
+	bool Propagate(State& state);
+	bool Search(State& state);
+private:
+	size_t limit = 1;
+	size_t solutions = 0;
+	size_t guesses = 0;
+	State firstSolution;
+	int pending[SudokuBoard::NUMBER_OF_CELLS];
+	int numberOfPending = 0;
+};
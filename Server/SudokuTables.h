@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+using DigitMask = uint16_t;
+
+// Every table starts on its own cache line and is built by the compiler, so the hot loops only load.
+struct SudokuTables
+{
+	static constexpr const int SIZE = 9;
+	static constexpr const int NUMBER_OF_CELLS = SIZE * SIZE;
+	static constexpr const DigitMask ALL_DIGITS = 0x1FF;
+	static constexpr const int NUMBER_OF_UNITS = 3 * SIZE;
+	static constexpr const int NUMBER_OF_PEERS = 20;
+	static constexpr const int UNITS_PER_CELL = 3;
+	static constexpr const size_t CACHE_LINE_SIZE = 64;
+	// units are the rows, then the columns, then the boxes
+	alignas(CACHE_LINE_SIZE) uint8_t units[NUMBER_OF_UNITS][SIZE];
+	alignas(CACHE_LINE_SIZE) uint8_t peers[NUMBER_OF_CELLS][NUMBER_OF_PEERS];
+	alignas(CACHE_LINE_SIZE) uint8_t unitsOf[NUMBER_OF_CELLS][UNITS_PER_CELL];
+	alignas(CACHE_LINE_SIZE) uint8_t rowOf[NUMBER_OF_CELLS];
+	alignas(CACHE_LINE_SIZE) uint8_t columnOf[NUMBER_OF_CELLS];
+	alignas(CACHE_LINE_SIZE) uint8_t boxOf[NUMBER_OF_CELLS];
+	alignas(CACHE_LINE_SIZE) DigitMask digitMasks[SIZE + 1];
+	alignas(CACHE_LINE_SIZE) uint8_t digitOf[ALL_DIGITS + 1];
+	alignas(CACHE_LINE_SIZE) uint8_t bitCounts[ALL_DIGITS + 1];
+};
+
+constexpr SudokuTables makeSudokuTables()
+{
+	constexpr const int SIZE = SudokuTables::SIZE;
+	SudokuTables tables{};
+	for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+	{
+		const int row = cell / SIZE;
+		const int column = cell % SIZE;
+		const int box = row / 3 * 3 + column / 3;
+		tables.rowOf[cell] = uint8_t(row);
+		tables.columnOf[cell] = uint8_t(column);
+		tables.boxOf[cell] = uint8_t(box);
+		tables.unitsOf[cell][0] = uint8_t(row);
+		tables.unitsOf[cell][1] = uint8_t(SIZE + column);
+		tables.unitsOf[cell][2] = uint8_t(2 * SIZE + box);
+		tables.units[row][column] = uint8_t(cell);
+		tables.units[SIZE + column][row] = uint8_t(cell);
+		tables.units[2 * SIZE + box][row % 3 * 3 + column % 3] = uint8_t(cell);
+	}
+	for (int cell = 0; cell < SudokuTables::NUMBER_OF_CELLS; ++cell)
+	{
+		int count = 0;
+		for (int other = 0; other < SudokuTables::NUMBER_OF_CELLS; ++other)
+		{
+			if (other != cell && (tables.rowOf[other] == tables.rowOf[cell] ||
+				tables.columnOf[other] == tables.columnOf[cell] || tables.boxOf[other] == tables.boxOf[cell]))
+			{
+				tables.peers[cell][count++] = uint8_t(other);
+			}
+		}
+	}
+	for (int digit = 1; digit <= SIZE; ++digit)
+	{
+		tables.digitMasks[digit] = DigitMask(1u << (digit - 1));
+	}
+	for (int mask = 1; mask <= SudokuTables::ALL_DIGITS; ++mask)
+	{
+		tables.bitCounts[mask] = uint8_t(tables.bitCounts[mask & (mask - 1)] + 1);
+		// the lowest digit in the mask
+		tables.digitOf[mask] = mask & 1 ? 1 : uint8_t(tables.digitOf[mask >> 1] + 1);
+	}
+	return tables;
+}
+
+inline constexpr SudokuTables sudokuTables = makeSudokuTables();
@@ -0,0 +1,25 @@
+#include "SudokuTransform.h"
+
+SudokuTransform::SudokuTransform()
+{
+	std::iota(std::begin(rows), std::end(rows), uint8_t(0));
+	std::iota(std::begin(columns), std::end(columns), uint8_t(0));
+	std::iota(std::begin(digits), std::end(digits), uint8_t(0));
+}
+
+SudokuBoard SudokuTransform::Apply(const SudokuBoard& board) const
+{
+	SudokuBoard result;
+	for (int row = 0; row < SudokuBoard::SIZE; ++row)
+	{
+		for (int column = 0; column < SudokuBoard::SIZE; ++column)
+		{
+			const int source = transpose ? columns[column] * SudokuBoard::SIZE + rows[row] : rows[row] * SudokuBoard::SIZE + columns[column];
+			if (const int digit = board.Get(source))
+			{
+				result.Place(row * SudokuBoard::SIZE + column, digits[digit]);
+			}
+		}
+	}
+	return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "SudokuBoard.h"
+#include <algorithm>
+#include <numeric>
+
+// A validity-preserving relabeling: optional transposition, then rows and columns taken
+// from source positions that stay within their band or stack, then a digit permutation.
+struct SudokuTransform
+{
+	SudokuTransform();
+	SudokuBoard Apply(const SudokuBoard& board) const;
+	template<typename Engine>
+	static SudokuTransform CreateRandom(Engine& engine);
+	bool transpose = false;
+	uint8_t rows[SudokuBoard::SIZE];
+	uint8_t columns[SudokuBoard::SIZE];
+	uint8_t digits[SudokuBoard::SIZE + 1];
+private:
+	template<typename Engine>
+	static void ShuffleLines(uint8_t (&lines)[SudokuBoard::SIZE], Engine& engine);
+};
+
+template<typename Engine>
+SudokuTransform SudokuTransform::CreateRandom(Engine& engine)
+{
+	SudokuTransform transform;
+	transform.transpose = engine() % 2 != 0;
+	ShuffleLines(transform.rows, engine);
+	ShuffleLines(transform.columns, engine);
+	std::shuffle(transform.digits + 1, transform.digits + SudokuBoard::SIZE + 1, engine);
+	return transform;
+}
+
+template<typename Engine>
+void SudokuTransform::ShuffleLines(uint8_t (&lines)[SudokuBoard::SIZE], Engine& engine)
+{
+	uint8_t bands[3] = { 0, 1, 2 };
+	std::shuffle(std::begin(bands), std::end(bands), engine);
+	for (int band = 0; band < 3; ++band)
+	{
+		uint8_t offsets[3] = { 0, 1, 2 };
+		std::shuffle(std::begin(offsets), std::end(offsets), engine);
+		for (int i = 0; i < 3; ++i)
+		{
+			lines[band * 3 + i] = uint8_t(bands[band] * 3 + offsets[i]);
+		}
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "RoomIndex.h"
+#include <string>
+
+class Connection;
+class Room;
+
+struct User
+{
+	User(const std::string& name, Connection& connection)
+		: name(name), connection(&connection)
+	{}
+	User(User&& other)
+		: name(std::move(other.name)), connection(other.connection), room(other.room), droppedFrames(other.droppedFrames), page(std::move(other.page))
+	{
+		other.connection = nullptr;
+		other.room = nullptr;
+	}
+
+	std::string name;
+	Connection* connection = nullptr;
+	Room* room = nullptr;
+	size_t droppedFrames = 0;
+	RoomPage page;
+};
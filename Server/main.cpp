@@ -4,7 +4,31 @@
 #include "Server.h"
 #include "NetworkException.h"
 #include "NetworkEnvironment.h"
+#include "ShutdownSignal.h"
 #include <fstream>
+#ifdef __linux__
+#include <sys/resource.h>
+
+// every connection holds a descriptor, the default soft limit of 1024 would cap the lobby
+static void raiseDescriptorLimit()
+{
+	rlimit limit;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+	{
+		limit.rlim_cur = limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+}
+#endif
+
+static void reportError(const char* text, const char* caption)
+{
+#ifdef __linux__
+	std::cerr << caption << ": " << text << '\n';
+#else
+	MessageBox(nullptr, text, caption, MB_OK | MB_ICONEXCLAMATION);
+#endif
+}
 
 int main(int argc, char* argv[])
 {
@@ -19,25 +43,31 @@ int main(int argc, char* argv[])
 		{
 			configFilePath = argv[1];
 		}
+#ifdef __linux__
+		raiseDescriptorLimit();
+#endif
+		ShutdownSignal shutdownSignal;
 		NetworkEnvironment::initialize();
 		Server server(configFilePath);
 		server.Start();
-		while (1);
+		shutdownSignal.Wait();
+		LOG << "shutting down\n";
+		server.Stop();
 	}
 	catch (const NetworkException& e)
 	{
-		MessageBox(nullptr, e.what(), e.getType(), MB_OK | MB_ICONEXCLAMATION);
+		reportError(e.what(), e.getType());
 		return 1;
 	}
-	catch (const std::exception e)
+	catch (const std::exception& e)
 	{
-		MessageBox(nullptr, e.what(), "Standar Exception", MB_OK | MB_ICONEXCLAMATION);
+		reportError(e.what(), "Standar Exception");
 		return 1;
 	}
 	catch (...)
 	{
-		MessageBox(nullptr, "No details avalible", "Unknown Exception", MB_OK | MB_ICONEXCLAMATION);
+		reportError("No details avalible", "Unknown Exception");
 		return 1;
 	}
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,139 @@
+#include "SolverBackend.h"
+#include "SudokuGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Corpus
+{
+	std::string name;
+	std::vector<SudokuBoard> puzzles;
+};
+
+static bool load(const std::string& path, Corpus& corpus)
+{
+	std::ifstream in(path);
+	if (!in)
+	{
+		return false;
+	}
+	corpus.name = path;
+	std::string line;
+	while (std::getline(in, line))
+	{
+		// one puzzle per line, anything after the first 81 characters is a comment
+		SudokuBoard board;
+		if (line.size() >= SudokuBoard::NUMBER_OF_CELLS && SudokuBoard::FromString(line.substr(0, SudokuBoard::NUMBER_OF_CELLS), board))
+		{
+			corpus.puzzles.push_back(board);
+		}
+	}
+	return true;
+}
+
+static Corpus generate(Difficulty difficulty, size_t count)
+{
+	Corpus corpus;
+	corpus.name = std::string("generated ") + toString(difficulty);
+	SudokuGenerator generator(uint32_t(difficulty) + 1);
+	while (corpus.puzzles.size() < count)
+	{
+		Puzzle puzzle = generator.Generate(difficulty);
+		if (puzzle.difficulty == difficulty)
+		{
+			corpus.puzzles.push_back(puzzle.clues);
+		}
+	}
+	return corpus;
+}
+
+template<typename Function>
+static double measure(const Corpus& corpus, Function function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (const SudokuBoard& puzzle : corpus.puzzles)
+	{
+		function(puzzle);
+	}
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return corpus.puzzles.empty() ? 0.0 : elapsed.count() / corpus.puzzles.size();
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<Corpus> corpora;
+	for (int i = 1; i < argc; ++i)
+	{
+		Corpus corpus;
+		if (!load(argv[i], corpus))
+		{
+			std::cerr << "could not open " << argv[i] << '\n';
+			return 1;
+		}
+		corpora.push_back(std::move(corpus));
+	}
+	if (corpora.empty())
+	{
+		std::cout << "usage: SolverBenchmark [corpus...], benchmarking generated puzzles\n";
+		for (size_t i = 0; i < size_t(Difficulty::count); ++i)
+		{
+			corpora.push_back(generate(Difficulty(i), 200));
+		}
+	}
+
+	std::unique_ptr<SolverBackend> solvers[size_t(SolverKind::count)];
+	for (size_t i = 0; i < size_t(SolverKind::count); ++i)
+	{
+		solvers[i] = createSolver(SolverKind(i));
+	}
+	// both backends branch on the first cell with the fewest candidates and try its digits in order,
+	// so on puzzles with a unique solution they usually walk the same tree and make the same guesses,
+	// the last column counts the puzzles where a backend guessed differently than the first one
+	std::printf("%-24s %8s %-14s %12s %12s %10s %10s\n", "corpus", "puzzles", "solver", "solve us", "unique us", "guesses", "differ");
+	for (const Corpus& corpus : corpora)
+	{
+		std::vector<std::string> reference;
+		std::vector<size_t> referenceGuesses;
+		for (size_t i = 0; i < size_t(SolverKind::count); ++i)
+		{
+			SolverBackend& solver = *solvers[i];
+			size_t guesses = 0;
+			std::vector<std::string> solutions;
+			std::vector<size_t> puzzleGuesses;
+			const double solve = measure(corpus, [&](const SudokuBoard& puzzle) {
+				SudokuBoard board = puzzle;
+				solver.Solve(board);
+				guesses += solver.GetNumberOfGuesses();
+				puzzleGuesses.push_back(solver.GetNumberOfGuesses());
+				solutions.push_back(board.ToString());
+			});
+			const double unique = measure(corpus, [&](const SudokuBoard& puzzle) {
+				solver.CountSolutions(puzzle, 2);
+			});
+			if (i == 0)
+			{
+				referenceGuesses = puzzleGuesses;
+			}
+			size_t differ = 0;
+			for (size_t j = 0; j < puzzleGuesses.size(); ++j)
+			{
+				differ += puzzleGuesses[j] != referenceGuesses[j] ? 1 : 0;
+			}
+			std::printf("%-24s %8zu %-14s %12.2f %12.2f %10.1f %10zu\n", corpus.name.c_str(), corpus.puzzles.size(), toString(SolverKind(i)),
+				solve, unique, corpus.puzzles.empty() ? 0.0 : double(guesses) / corpus.puzzles.size(), differ);
+			if (i == 0)
+			{
+				reference = std::move(solutions);
+			}
+			else if (solutions != reference)
+			{
+				std::cerr << toString(SolverKind(i)) << " disagrees with " << toString(SolverKind(0)) << " on " << corpus.name << '\n';
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <iostream>
+
+// a failed check is reported and counted, a suite keeps going so one run shows every failure
+extern int failedChecks;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			++failedChecks; \
+			std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed\n"; \
+		} \
+	} while (false)
+
+void testProtocol();
+void testOutboundQueue();
+void testLobbyLog();
+void testRoomIndex();
@@ -0,0 +1,48 @@
+#include "Check.h"
+#include "LobbyLog.h"
+#include <vector>
+
+namespace
+{
+	LobbyLog::Frames makeFrames(const std::string& text)
+	{
+		return { std::make_shared<const std::string>("json " + text), std::make_shared<const std::string>("binary " + text) };
+	}
+}
+
+void testLobbyLog()
+{
+	LobbyLog log(3);
+	CHECK(log.GetVersion() == 0 && log.CountSince(0) == 0);
+	for (int i = 1; i <= 5; ++i)
+	{
+		log.Append(makeFrames(std::to_string(i)), i % 2 ? i : 0);
+	}
+	CHECK(log.GetVersion() == 5);
+	CHECK(log.CountSince(5) == 0);
+	CHECK(log.CountSince(2) == 3);
+	// the first two changes fell out of the log, and a version from the future was never handed out
+	CHECK(log.CountSince(1) == -1);
+	CHECK(log.CountSince(0) == -1);
+	CHECK(log.CountSince(6) == -1);
+
+	std::vector<std::string> replayed;
+	std::vector<int> roomIds;
+	log.ReplaySince(3, Encoding::binary, [&](const SharedFrame& frame, int roomId) {
+		replayed.push_back(*frame);
+		roomIds.push_back(roomId);
+	});
+	CHECK((replayed == std::vector<std::string>{ "binary 4", "binary 5" }));
+	CHECK((roomIds == std::vector<int>{ 0, 5 }));
+	replayed.clear();
+	log.ReplaySince(5, Encoding::json, [&](const SharedFrame& frame, int) {
+		replayed.push_back(*frame);
+	});
+	CHECK(replayed.empty());
+
+	log.SetCapacity(1);
+	CHECK(log.CountSince(4) == 1 && log.CountSince(3) == -1);
+	LobbyLog disabled(0);
+	disabled.Append(makeFrames("1"));
+	CHECK(disabled.GetVersion() == 1 && disabled.CountSince(1) == 0 && disabled.CountSince(0) == -1);
+}
@@ -0,0 +1,146 @@
+#include "Check.h"
+#include "MessageFrame.h"
+#include "OutboundQueue.h"
+#include <vector>
+#ifdef __linux__
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	SharedFrame makeFrame(const std::string& text)
+	{
+		return std::make_shared<const std::string>(text);
+	}
+
+	void testDisconnect()
+	{
+		OutboundQueue queue(2, OverflowPolicy::disconnect);
+		CHECK(queue.IsEmpty());
+		CHECK(queue.Push(makeFrame("a"), 0, true));
+		CHECK(queue.Push(makeFrame("b"), 0, true));
+		CHECK(!queue.Push(makeFrame("c"), 0, true));
+		CHECK(queue.GetSize() == 2 && queue.GetDropped() == 0);
+	}
+
+	void testDropOldest()
+	{
+		OutboundQueue queue(2, OverflowPolicy::dropOldest);
+		CHECK(queue.Push(makeFrame("a"), 0, false));
+		CHECK(queue.Push(makeFrame("b"), 0, true));
+		CHECK(queue.Push(makeFrame("c"), 0, false));
+		CHECK(queue.GetSize() == 2 && queue.GetDropped() == 1);
+		// nothing droppable is left, the queue overflows
+		CHECK(!queue.Push(makeFrame("d"), 0, true));
+		CHECK(queue.GetSize() == 2 && queue.GetDropped() == 1);
+	}
+
+	void testCoalesce()
+	{
+		OutboundQueue queue(2, OverflowPolicy::coalesce);
+		CHECK(queue.Push(makeFrame("a1"), 7, false));
+		CHECK(queue.Push(makeFrame("b"), 0, true));
+		// the newer frame of room 7 replaces the queued one instead of dropping anything
+		CHECK(queue.Push(makeFrame("a2"), 7, false));
+		CHECK(queue.GetSize() == 2 && queue.GetDropped() == 0);
+		// without a key coalescing falls back to dropping the oldest droppable frame
+		CHECK(queue.Push(makeFrame("c"), 0, false));
+		CHECK(queue.GetSize() == 2 && queue.GetDropped() == 1);
+		CHECK(!queue.Push(makeFrame("d"), 9, false));
+	}
+
+	void testResync()
+	{
+		OutboundQueue queue(3, OverflowPolicy::dropOldest);
+		CHECK(queue.Push(makeFrame("reply"), 0, false));
+		CHECK(queue.Push(makeFrame("change 1"), 7, true));
+		CHECK(queue.Push(makeFrame("change 2"), 9, true));
+		// the lists replace the queued changes, which were superseded rather than dropped
+		CHECK(queue.Resync({ makeFrame("users 1"), makeFrame("rooms 1") }));
+		CHECK(queue.GetSize() == 3 && queue.GetDropped() == 0);
+		// a second resync replaces the first one instead of piling up
+		CHECK(queue.Resync({ makeFrame("users 2"), makeFrame("rooms 2") }));
+		CHECK(queue.GetSize() == 3);
+		CHECK(!queue.Push(makeFrame("change 3"), 7, true));
+		OutboundQueue full(2, OverflowPolicy::dropOldest);
+		CHECK(full.Push(makeFrame("reply 1"), 0, false));
+		CHECK(full.Push(makeFrame("reply 2"), 0, false));
+		CHECK(!full.Resync({ makeFrame("users"), makeFrame("rooms") }));
+	}
+
+#ifdef __linux__
+	std::vector<std::string> receiveFrames(int fd)
+	{
+		std::string data;
+		char buffer[4096];
+		ssize_t received = 0;
+		while ((received = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+		{
+			data.append(buffer, size_t(received));
+		}
+		std::vector<std::string> frames;
+		const char* payload = nullptr;
+		uint32_t payloadSize = 0;
+		size_t offset = 0;
+		while (peekFrame(data.data() + offset, data.size() - offset, payload, payloadSize) == Result::success)
+		{
+			frames.emplace_back(payload, payloadSize);
+			offset += FRAME_HEADER_SIZE + payloadSize;
+		}
+		CHECK(offset == data.size());
+		return frames;
+	}
+
+	void testFlush()
+	{
+		int fds[2];
+		if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds) != 0)
+		{
+			CHECK(!"socketpair failed");
+			return;
+		}
+		// more frames than one batch, all of them arrive framed and in order
+		OutboundQueue queue(100, OverflowPolicy::disconnect);
+		std::vector<std::string> sent;
+		for (int i = 0; i < 70; ++i)
+		{
+			sent.push_back("frame " + std::to_string(i));
+			CHECK(queue.Push(makeFrame(sent.back()), 0, false));
+		}
+		{
+			Socket socket(IPVersion::IPv4, fds[0]);
+			CHECK(queue.Flush(socket) == Result::success);
+			CHECK(queue.IsEmpty());
+		}
+		CHECK(receiveFrames(fds[1]) == sent);
+
+		// a resync keeps the replies in order and sends the lists in place of the changes
+		OutboundQueue resynced(8, OverflowPolicy::dropOldest);
+		resynced.Push(makeFrame("reply"), 0, false);
+		resynced.Push(makeFrame("change"), 7, true);
+		resynced.Resync({ makeFrame("users"), makeFrame("rooms") });
+		resynced.Push(makeFrame("later"), 9, true);
+		int resyncFds[2];
+		CHECK(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, resyncFds) == 0);
+		{
+			Socket socket(IPVersion::IPv4, resyncFds[0]);
+			CHECK(resynced.Flush(socket) == Result::success);
+		}
+		CHECK((receiveFrames(resyncFds[1]) == std::vector<std::string>{ "reply", "users", "rooms", "later" }));
+		close(resyncFds[1]);
+		close(fds[1]);
+	}
+#endif
+}
+
+void testOutboundQueue()
+{
+	testDisconnect();
+	testDropOldest();
+	testCoalesce();
+	testResync();
+#ifdef __linux__
+	testFlush();
+#endif
+}
@@ -0,0 +1,142 @@
+#include "Check.h"
+#include "Protocol.h"
+
+namespace
+{
+	Result decode(const std::string& payload, Encoding encoding, Request& request)
+	{
+		request = Request();
+		return decodeRequest(payload.data(), payload.size(), encoding, request);
+	}
+
+	bool rejects(const std::string& payload, Encoding encoding)
+	{
+		Request request;
+		return decode(payload, encoding, request) != Result::success;
+	}
+
+	void testJsonRequests()
+	{
+		Request request;
+		CHECK(decode(R"({"type":"join","roomId":"12"})", Encoding::json, request) == Result::success);
+		CHECK(request.type == MessageType::join && request.roomId == 12 && request.Has(Field::roomId));
+		CHECK(decode(R"({"type":"listRooms","cursor":"7","limit":5,"open":true})", Encoding::json, request) == Result::success);
+		CHECK(request.type == MessageType::listRooms && request.cursor == 7 && request.limit == 5 && request.open);
+		CHECK(!request.Has(Field::unlocked) && !request.Has(Field::difficulty));
+		CHECK(decode(R"({"type":"connect","name":"café","encoding":"binary"})", Encoding::json, request) == Result::success);
+		CHECK(request.name == "caf\xc3\xa9" && request.encoding == Encoding::binary);
+		// a type the server does not handle still decodes, into the json tree
+		CHECK(decode(R"({"type":"somethingNew","value":[1,{"a":null}]})", Encoding::json, request) == Result::success);
+		CHECK(request.type == MessageType::unknown && request.message["value"][1]["a"].is_null());
+	}
+
+	void testMalformedJson()
+	{
+		CHECK(rejects("", Encoding::json));
+		CHECK(rejects("[1,2]", Encoding::json));
+		CHECK(rejects(R"({"type":"join","roomId":12)", Encoding::json));
+		CHECK(rejects(R"({"type":"join" "roomId":1})", Encoding::json));
+		CHECK(rejects(R"({"type":"join","roomId":01})", Encoding::json));
+		CHECK(rejects(R"({"type":"join","roomId":99999999999})", Encoding::json));
+		CHECK(rejects(R"({"type":"placeDigit","cell":1.5})", Encoding::json));
+		CHECK(rejects(R"({"type":"lock","lock":"yes"})", Encoding::json));
+		CHECK(rejects("{\"type\":\"connect\",\"name\":\"\xff\xfe\"}", Encoding::json));
+		CHECK(rejects(R"({"type":"x","a":[[[[[[[[[[1]]]]]]]]]]})", Encoding::json));
+		const std::string valid = R"({"type":"listRooms","cursor":"7","limit":5,"open":true})";
+		for (size_t size = 0; size < valid.size(); ++size)
+		{
+			CHECK(rejects(valid.substr(0, size), Encoding::json));
+		}
+	}
+
+	void testBinaryRequests()
+	{
+		MessageWriter writer(Encoding::binary, MessageType::listRooms);
+		writer.RoomId(Field::cursor, 7)
+			.Integer(Field::limit, 5)
+			.Boolean(Field::open, true)
+			.Integer(Field::difficulty, 2);
+		const std::string payload = writer.Release();
+		Request request;
+		CHECK(decode(payload, Encoding::binary, request) == Result::success);
+		CHECK(request.type == MessageType::listRooms && request.cursor == 7 && request.limit == 5);
+		CHECK(request.open && !request.unlocked && request.difficulty == 2 && request.Has(Field::difficulty));
+		CHECK(peekMessageType(payload.data(), payload.size(), Encoding::binary) == MessageType::listRooms);
+		// every truncation of a valid message and every byte after its end are errors
+		for (size_t size = 0; size < payload.size(); ++size)
+		{
+			CHECK(rejects(payload.substr(0, size), Encoding::binary));
+		}
+		CHECK(rejects(payload + 'x', Encoding::binary));
+		std::string unknownField = payload;
+		unknownField[2] = char(200);
+		CHECK(rejects(unknownField, Encoding::binary));
+		std::string unknownType = payload;
+		unknownType[0] = char(250);
+		CHECK(rejects(unknownType, Encoding::binary));
+	}
+
+	void testBinaryUtf8()
+	{
+		// a binary client must not register a name that json clients cannot parse
+		for (const std::string& name : { std::string("\xff\xfe"), std::string("caf\xc3"), std::string("\xc0\xaf"), std::string("\xed\xa0\x80") })
+		{
+			MessageWriter writer(Encoding::binary, MessageType::connect);
+			writer.String(Field::name, name);
+			CHECK(rejects(writer.Release(), Encoding::binary));
+		}
+		MessageWriter writer(Encoding::binary, MessageType::connect);
+		writer.String(Field::name, "caf\xc3\xa9 \xf0\x9f\x98\x80");
+		Request request;
+		CHECK(decode(writer.Release(), Encoding::binary, request) == Result::success);
+		CHECK(request.name == "caf\xc3\xa9 \xf0\x9f\x98\x80");
+	}
+
+	void testBinaryMatchesJson()
+	{
+		// a message encoded both ways decodes to the same request
+		Json message;
+		message["type"] = "connect";
+		message["name"] = "alice";
+		message["encoding"] = "binary";
+		message["epoch"] = 12345;
+		message["version"] = 42;
+		message["limit"] = 50;
+		for (Encoding encoding : { Encoding::json, Encoding::binary })
+		{
+			Request request;
+			CHECK(decode(encodeMessage(message, encoding), encoding, request) == Result::success);
+			CHECK(request.type == MessageType::connect && request.name == "alice" && request.encoding == Encoding::binary);
+			CHECK(request.epoch == 12345 && request.version == 42 && request.limit == 50 && request.Has(Field::limit));
+		}
+	}
+	void testStatsMessage()
+	{
+		// the stats response nests literal keys and fractions, both encodings have to carry them
+		Json level;
+		level["difficulty"] = "hard";
+		level["depth"] = 3;
+		level["refillRate"] = 2.5;
+		const Json puzzles = Json::array({ level });
+		for (Encoding encoding : { Encoding::json, Encoding::binary })
+		{
+			MessageWriter writer(encoding, MessageType::stats);
+			writer.Value("users", 2).Value("puzzles", puzzles);
+			const std::string payload = writer.Release();
+			Json message;
+			MessageType type = MessageType::unknown;
+			CHECK(decodeMessage(payload.data(), payload.size(), encoding, message, type) == Result::success);
+			CHECK(type == MessageType::stats && message["users"] == 2 && message["puzzles"] == puzzles);
+		}
+	}
+}
+
+void testProtocol()
+{
+	testJsonRequests();
+	testMalformedJson();
+	testBinaryRequests();
+	testBinaryUtf8();
+	testBinaryMatchesJson();
+	testStatsMessage();
+}
@@ -0,0 +1,101 @@
+#include "Check.h"
+#include "Room.h"
+#include "RoomIndex.h"
+#include <list>
+#include <vector>
+
+namespace
+{
+	std::vector<int> page(const RoomIndex& index, int cursor, const RoomFilter& filter, size_t limit, int& next)
+	{
+		std::vector<int> ids;
+		next = index.Page(cursor, filter, limit, ids);
+		return ids;
+	}
+}
+
+void testRoomIndex()
+{
+	// room ids only grow, the twelve rooms below are numbered from first on
+	std::list<Room> rooms;
+	RoomIndex index;
+	for (int i = 0; i < 12; ++i)
+	{
+		rooms.emplace_back("host" + std::to_string(i), nullptr);
+		Room& room = rooms.back();
+		if (i % 3 == 0)
+		{
+			room.SetGuest("guest" + std::to_string(i), nullptr);
+		}
+		room.SetLock(i % 4 == 0);
+		room.SetDifficulty(i % int(Difficulty::count));
+		index.Insert(room);
+	}
+	const int first = rooms.front().GetId();
+
+	int next = 0;
+	std::vector<int> all;
+	for (int cursor = 0;; cursor = next)
+	{
+		const std::vector<int> ids = page(index, cursor, RoomFilter(), 5, next);
+		CHECK(ids.size() <= 5);
+		all.insert(all.end(), ids.begin(), ids.end());
+		if (next == 0)
+		{
+			break;
+		}
+		CHECK(next == ids.back());
+	}
+	CHECK(all.size() == 12 && all.front() == first && all.back() == first + 11);
+	for (size_t i = 1; i < all.size(); ++i)
+	{
+		CHECK(all[i] == all[i - 1] + 1);
+	}
+
+	RoomFilter filter;
+	filter.open = true;
+	filter.unlocked = true;
+	for (const Room& room : rooms)
+	{
+		CHECK(filter.Matches(room) == (!room.GetGuest() && !room.IsLocked()));
+	}
+	std::vector<int> expected;
+	for (const Room& room : rooms)
+	{
+		if (filter.Matches(room))
+		{
+			expected.push_back(room.GetId());
+		}
+	}
+	CHECK(page(index, 0, filter, 100, next) == expected && next == 0);
+	CHECK(page(index, 0, filter, 2, next) == std::vector<int>(expected.begin(), expected.begin() + 2) && next == expected[1]);
+
+	filter = RoomFilter();
+	filter.difficulty = 2;
+	CHECK((page(index, 0, filter, 100, next) == std::vector<int>{ first + 2, first + 6, first + 10 }));
+	CHECK((page(index, first + 2, filter, 1, next) == std::vector<int>{ first + 6 }) && next == first + 6);
+
+	// a changed room moves between buckets, an erased one leaves every page
+	Room& changed = *std::next(rooms.begin(), 2);
+	changed.SetDifficulty(3);
+	index.Update(changed);
+	CHECK((page(index, 0, filter, 100, next) == std::vector<int>{ first + 6, first + 10 }));
+	index.Erase(first + 6);
+	CHECK((page(index, 0, filter, 100, next) == std::vector<int>{ first + 10 }));
+	CHECK(page(index, first + 10, filter, 100, next).empty() && next == 0);
+
+	RoomPage roomPage;
+	roomPage.filter = filter;
+	roomPage.limit = 2;
+	roomPage.tail = true;
+	roomPage.ids = { first + 10 };
+	CHECK(roomPage.Contains(first + 10) && !roomPage.Contains(first + 6));
+	Room& late = rooms.back();
+	late.SetDifficulty(2);
+	CHECK(roomPage.Accepts(late));
+	roomPage.tail = false;
+	CHECK(!roomPage.Accepts(late));
+	roomPage.tail = true;
+	late.SetDifficulty(1);
+	CHECK(!roomPage.Accepts(late));
+}
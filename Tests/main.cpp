@@ -0,0 +1,39 @@
+#include "Check.h"
+#include <cstring>
+
+int failedChecks = 0;
+
+namespace
+{
+	struct Suite
+	{
+		const char* name;
+		void (*run)();
+	};
+
+	constexpr const Suite SUITES[] = {
+		{ "protocol", testProtocol },
+		{ "outboundQueue", testOutboundQueue },
+		{ "lobbyLog", testLobbyLog },
+		{ "roomIndex", testRoomIndex }
+	};
+}
+
+int main(int argc, char* argv[])
+{
+	bool found = false;
+	for (const Suite& suite : SUITES)
+	{
+		if (argc < 2 || std::strcmp(argv[1], suite.name) == 0)
+		{
+			suite.run();
+			found = true;
+		}
+	}
+	if (!found)
+	{
+		std::cerr << "unknown suite " << argv[1] << '\n';
+		return 1;
+	}
+	return failedChecks ? 1 : 0;
+}